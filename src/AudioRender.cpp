@@ -0,0 +1,139 @@
+#include "AudioRender.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <random>
+
+#include "Oil.h"
+#include "Rollout.h"
+
+namespace {
+
+// Oil extent of the default 1024x768 window, matching ofApp::setup
+const float HEADLESS_OIL_BOTTOM_Y = 548.8f;
+const float HEADLESS_OIL_LEFT_X = 271.0f;
+const float HEADLESS_OIL_RIGHT_X = 753.0f;
+
+const float FRY_STEP = 1.0f / 60.0f;
+const int BUBBLE_SUBSTEPS = 4;
+const int MAX_RELEASES_PER_STEP = 64;
+
+void writeLittleEndian(std::ofstream& file, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        file.put((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+}  // namespace
+
+std::vector<BubbleSoundEvent> simulateFryingEvents(float oilTemperature,
+                                                   float duration) {
+    Oil oil(HEADLESS_OIL_SURFACE_Y, oilTemperature);
+    Potato fry = makeDroppedFry(HEADLESS_OIL_SURFACE_Y, 1);
+    std::vector<Bubble> bubbles;
+    std::vector<BubbleSoundEvent> events;
+    std::mt19937 rng(1);  // Bubble shapes; fixed, like the fry's seed
+
+    float bubbleStep = FRY_STEP / BUBBLE_SUBSTEPS;
+    // Step count, not an accumulated float, so event times don't drift
+    int numSteps = (int)lround(duration / FRY_STEP);
+    for (int step = 0; step < numSteps; step++) {
+        float time = step * FRY_STEP;
+        fry.update(FRY_STEP, oil.temperature, HEADLESS_OIL_SURFACE_Y,
+                   oil.getDensity(), HEADLESS_BASKET_BOTTOM_Y);
+
+        float releaseTimes[MAX_RELEASES_PER_STEP];
+        ofVec2f sites[MAX_RELEASES_PER_STEP];
+        int numBubbles = fry.sampleBubbleReleases(
+            oil.temperature, FRY_STEP, releaseTimes, MAX_RELEASES_PER_STEP);
+        fry.sampleBubbleSites(numBubbles, sites);
+        for (int i = 0; i < numBubbles; i++) {
+            ofVec2f position = sites[i];
+            position.y = ofClamp(position.y, HEADLESS_OIL_SURFACE_Y + 5,
+                                 HEADLESS_OIL_BOTTOM_Y - 5);
+            bubbles.push_back(Bubble(position, oil.temperature,
+                                     position.y - HEADLESS_OIL_SURFACE_Y,
+                                     HEADLESS_OIL_SURFACE_Y, rng));
+            bubbles.back().spawnDelay = releaseTimes[i];
+        }
+
+        for (int i = 0; i < BUBBLE_SUBSTEPS; i++) {
+            float stepEnd = time + (i + 1) * bubbleStep;
+            for (auto& bubble : bubbles) {
+                bool wasAtSurface = bubble.reachedSurface;
+                bubble.update(bubbleStep, oil.getViscosity());
+                if (bubble.reachedSurface && !wasAtSurface) {
+                    events.push_back(makeBubbleSoundEvent(
+                        bubble, stepEnd, HEADLESS_OIL_LEFT_X,
+                        HEADLESS_OIL_RIGHT_X));
+                }
+            }
+        }
+
+        bubbles.erase(std::remove_if(bubbles.begin(), bubbles.end(),
+                                     [](Bubble& b) { return b.isDead; }),
+                      bubbles.end());
+    }
+
+    return events;
+}
+
+bool renderFryingWav(const std::vector<BubbleSoundEvent>& events,
+                     float duration, float sampleRate,
+                     const std::string& path) {
+    const int numChannels = 2;
+    int numFrames = (int)(duration * sampleRate);
+    std::vector<float> samples((size_t)numFrames * numChannels, 0.0f);
+
+    std::vector<BubbleSoundEvent> sorted = events;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const BubbleSoundEvent& a, const BubbleSoundEvent& b) {
+                         return a.time < b.time;
+                     });
+
+    // Render up to each event's sample, then start its voice there
+    std::unique_ptr<FryingSound> sound(new FryingSound(sampleRate));
+    int frame = 0;
+    for (const auto& event : sorted) {
+        int eventFrame = std::min(numFrames, (int)(event.time * sampleRate));
+        if (eventFrame > frame) {
+            sound->render(&samples[(size_t)frame * numChannels],
+                          eventFrame - frame, numChannels);
+            frame = eventFrame;
+        }
+        if (frame == numFrames) break;
+        sound->startVoice(event);
+    }
+    if (frame < numFrames) {
+        sound->render(&samples[(size_t)frame * numChannels],
+                      numFrames - frame, numChannels);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        ofLogError("AudioRender") << "cannot write " << path;
+        return false;
+    }
+
+    uint32_t dataBytes = (uint32_t)samples.size() * 2;
+    file.write("RIFF", 4);
+    writeLittleEndian(file, 36 + dataBytes, 4);
+    file.write("WAVEfmt ", 8);
+    writeLittleEndian(file, 16, 4);  // PCM format chunk size
+    writeLittleEndian(file, 1, 2);   // PCM
+    writeLittleEndian(file, numChannels, 2);
+    writeLittleEndian(file, (uint32_t)sampleRate, 4);
+    writeLittleEndian(file, (uint32_t)sampleRate * numChannels * 2, 4);
+    writeLittleEndian(file, numChannels * 2, 2);
+    writeLittleEndian(file, 16, 2);
+    file.write("data", 4);
+    writeLittleEndian(file, dataBytes, 4);
+    for (float sample : samples) {
+        int16_t value = (int16_t)(ofClamp(sample, -1.0f, 1.0f) * 32767.0f);
+        writeLittleEndian(file, (uint16_t)value, 2);
+    }
+    return (bool)file;
+}
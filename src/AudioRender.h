@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "FryingSound.h"
+
+/**
+ * Headless frying audio. simulateFryingEvents drops a fry into oil held at
+ * a fixed set point and runs the viewer's bubble model (fries at 60 Hz,
+ * bubbles sub-cycled 4x) without rendering, recording the time each bubble
+ * breaks the surface. renderFryingWav feeds those events through the live
+ * FryingSound synthesis, starting every voice on its exact sample, and
+ * writes 16-bit stereo PCM.
+ */
+std::vector<BubbleSoundEvent> simulateFryingEvents(float oilTemperature,
+                                                   float duration);
+
+bool renderFryingWav(const std::vector<BubbleSoundEvent>& events,
+                     float duration, float sampleRate,
+                     const std::string& path);
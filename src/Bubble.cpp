@@ -1,14 +1,34 @@
 #include "Bubble.h"
 
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+std::atomic<uint32_t> nextBubbleId(1);
+
+}  // namespace
+
 Bubble::Bubble(ofVec2f pos, float oilTemp, float depthBelowSurface,
-               float surfaceY) {
+               float surfaceY, std::mt19937& rng, float minStartSize) {
+    auto random = [&rng](float low, float high) {
+        return std::uniform_real_distribution<float>(low, high)(rng);
+    };
+
+    id = nextBubbleId.fetch_add(1, std::memory_order_relaxed);
     position = pos;
     oilSurfaceY = surfaceY;
     initialDepth = depthBelowSurface;
+    spawnDelay = 0.0f;
     reachedSurface = false;
 
     // Bubble type classification based on depth-to-radius ratio (h/R) [5]
-    float estimatedRadius = ofRandom(2.5f, 7.0f);
+    // Sizes past 7 only come from type 2, i.e. radii up to depth / 1.5
+    float maxRadius = 7.0f;
+    if (minStartSize > 0.0f) {
+        maxRadius = ofClamp(depthBelowSurface / 1.5f, 2.5f, 7.0f);
+    }
+    float estimatedRadius = random(2.5f, maxRadius);
     float h_R_ratio = depthBelowSurface / estimatedRadius;
 
     if (h_R_ratio < 0.5f) {
@@ -21,23 +41,23 @@ Bubble::Bubble(ofVec2f pos, float oilTemp, float depthBelowSurface,
 
     // Type-specific initialization (oscillationSpeed set only for Type 2)
     if (bubbleType == 0) {
-        velocity = ofVec2f(ofRandom(-70, 70), ofRandom(-140, -200));
-        startSize = ofRandom(3, 7);
-        endSize = startSize * ofRandom(0.15f, 0.35f);
-        lifespan = ofRandom(0.4f, 0.9f);
+        velocity = ofVec2f(random(-70, 70), random(-140, -200));
+        startSize = random(3, 7);
+        endSize = startSize * random(0.15f, 0.35f);
+        lifespan = random(0.4f, 0.9f);
         maxTrailLength = 3;
     } else if (bubbleType == 1) {
-        velocity = ofVec2f(ofRandom(-20, 20), ofRandom(-150, -220));
-        startSize = ofRandom(3, 6);
-        endSize = startSize * ofRandom(1.8f, 2.8f);
-        lifespan = ofRandom(0.7f, 1.4f);
+        velocity = ofVec2f(random(-20, 20), random(-150, -220));
+        startSize = random(3, 6);
+        endSize = startSize * random(1.8f, 2.8f);
+        lifespan = random(0.7f, 1.4f);
         maxTrailLength = 6;
     } else {
-        velocity = ofVec2f(ofRandom(-25, 25), ofRandom(-80, -130));
-        startSize = ofRandom(6, 14);
-        endSize = startSize * ofRandom(0.9f, 1.3f);
-        lifespan = ofRandom(1.2f, 2.5f);
-        oscillationSpeed = ofRandom(14, 30);
+        velocity = ofVec2f(random(-25, 25), random(-80, -130));
+        startSize = random(std::max(6.0f, minStartSize), 14.0f);
+        endSize = startSize * random(0.9f, 1.3f);
+        lifespan = random(1.2f, 2.5f);
+        oscillationSpeed = random(14, 30);
         maxTrailLength = 8;
     }
 
@@ -46,7 +66,7 @@ Bubble::Bubble(ofVec2f pos, float oilTemp, float depthBelowSurface,
     life = 1.0f;
     oscillation = 0.0f;
     if (bubbleType != 2) oscillationSpeed = 0.0f;
-    wobblePhase = ofRandom(0, TWO_PI);
+    wobblePhase = random(0, TWO_PI);
     acceleration = ofVec2f(0, 0);
     isDead = false;
 
@@ -55,7 +75,23 @@ Bubble::Bubble(ofVec2f pos, float oilTemp, float depthBelowSurface,
     color = ofColor(baseIntensity, baseIntensity - 5, baseIntensity - 30, 200);
 }
 
+float Bubble::getLargeFraction(float depthBelowSurface, float minSize) {
+    // Type 2 needs estimatedRadius <= depth / 1.5, radius ~ U(2.5, 7); its
+    // start size is U(6, 14)
+    float typeTwo = ofClamp((depthBelowSurface / 1.5f - 2.5f) / 4.5f, 0, 1);
+    float large = ofClamp((14.0f - std::max(6.0f, minSize)) / 8.0f, 0, 1);
+    return typeTwo * large;
+}
+
 void Bubble::update(float dt, float oilViscosity) {
+    // Released part-way through a step: only the remainder moves it
+    if (spawnDelay > 0) {
+        float wait = std::min(dt, spawnDelay);
+        spawnDelay -= wait;
+        dt -= wait;
+        if (dt <= 0) return;
+    }
+
     life -= dt / lifespan;
     if (life <= 0) {
         isDead = true;
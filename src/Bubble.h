@@ -1,5 +1,7 @@
 #pragma once
 
+#include <random>
+
 #include "ofMain.h"
 
 /**
@@ -16,13 +18,24 @@
  */
 class Bubble {
    public:
+    // Random size, shape and motion are drawn from rng. minStartSize > 7
+    // (above the type 0/1 range) draws only bubbles that start at least
+    // that large, as if the rest had been rejected.
     Bubble(ofVec2f pos, float oilTemp, float depthBelowSurface,
-           float oilSurfaceY);
+           float oilSurfaceY, std::mt19937& rng, float minStartSize = 0.0f);
+
+    // Fraction of bubbles released at this depth that start at least
+    // minSize (> 7) across
+    static float getLargeFraction(float depthBelowSurface, float minSize);
 
     void update(float dt, float oilViscosity);
     void draw();
     void applyForce(ofVec2f force);
 
+    // Unique per process and increasing in creation order, so a list kept
+    // in spawn order (appended, erased stably) has increasing ids
+    uint32_t id;
+
     ofVec2f position;
     ofVec2f velocity;
     ofVec2f acceleration;
@@ -37,6 +50,7 @@ class Bubble {
     float wobblePhase;
     float oilSurfaceY;
     float initialDepth;
+    float spawnDelay;  // s into the current step before release
 
     int bubbleType;
     bool isDead;
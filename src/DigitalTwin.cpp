@@ -0,0 +1,144 @@
+#include "DigitalTwin.h"
+
+#include <algorithm>
+#include <cmath>
+
+TwinBasket::TwinBasket(int id, double dropTime)
+    : id(id),
+      fry(makeDroppedFry(HEADLESS_OIL_SURFACE_Y, id)),
+      dropTime(dropTime),
+      time(dropTime),
+      doneTime(-1.0f),
+      predictedDone(-1.0f) {
+    std::fill(leadErrors, leadErrors + NUM_LEADS, NAN);
+}
+
+void TwinBasket::summarize() {
+    for (int i = 0; i < NUM_LEADS; i++) {
+        leadErrors[i] = getPredictionError(LEAD_TIMES[i]);
+    }
+    std::vector<std::pair<double, double>>().swap(predictions);
+}
+
+float TwinBasket::getPredictionError(float leadTime) const {
+    if (doneTime < 0.0f) return NAN;
+    float error = NAN;
+    for (const auto& prediction : predictions) {
+        if (prediction.first > doneTime - leadTime) break;
+        if (prediction.second >= 0.0f) error = prediction.second - doneTime;
+    }
+    return error;
+}
+
+DigitalTwin::DigitalTwin()
+    : time(0.0),
+      oilTemperature(0.0f),
+      setPoint(-1.0f),
+      hasSample(false),
+      maxLifted(64),
+      step(0.25f),
+      horizon(900.0f),
+      oil(HEADLESS_OIL_SURFACE_Y, 175.0f),
+      stepEnd(0.0) {}
+
+void DigitalTwin::apply(const SensorMessage& message) {
+    switch (message.type) {
+        case SensorMessage::SAMPLE:
+            // Out-of-order or repeated samples can't be assimilated
+            if (hasSample && message.time <= time) return;
+            if (hasSample) assimilate(message.time, message.value);
+            time = message.time;
+            oilTemperature = message.value;
+            hasSample = true;
+            break;
+
+        case SensorMessage::SET_POINT:
+            setPoint = message.value;
+            return;
+
+        case SensorMessage::DROP: {
+            if (findBasket(message.basket) != nullptr) return;
+            std::unique_ptr<TwinBasket> basket(
+                new TwinBasket(message.basket, std::max(message.time, time)));
+
+            // Event times are in oil-contact seconds; convert to sensor time
+            TwinBasket* target = basket.get();
+            basket->fry.onEvent = [this, target](const FryEvent& event) {
+                if (event.type != FryEvent::DONE) return;
+                target->doneTime =
+                    stepEnd - (target->fry.timeInOil - event.time);
+            };
+            baskets.push_back(std::move(basket));
+
+            // The other forecasts don't change
+            if (hasSample) predict(*baskets.back());
+            return;
+        }
+
+        case SensorMessage::LIFT:
+            for (size_t i = 0; i < baskets.size(); i++) {
+                if (baskets[i]->id != message.basket) continue;
+                baskets[i]->fry.onEvent = nullptr;
+                baskets[i]->summarize();
+                lifted.push_back(std::move(baskets[i]));
+                baskets.erase(baskets.begin() + i);
+                if ((int)lifted.size() > maxLifted) {
+                    lifted.erase(lifted.begin(),
+                                 lifted.end() - std::max(maxLifted, 0));
+                }
+                return;
+            }
+            return;
+    }
+
+    // A new reading moves every forecast
+    for (auto& basket : baskets) predict(*basket);
+}
+
+const TwinBasket* DigitalTwin::findBasket(int id) const {
+    for (const auto& basket : baskets) {
+        if (basket->id == id) return basket.get();
+    }
+    for (const auto& basket : lifted) {
+        if (basket->id == id) return basket.get();
+    }
+    return nullptr;
+}
+
+void DigitalTwin::assimilate(double sampleTime, float sampleTemperature) {
+    // Oil temperature is linear between the previous sample and this one
+    float slope =
+        (sampleTemperature - oilTemperature) / (float)(sampleTime - time);
+    for (auto& basket : baskets) {
+        double t = std::max(basket->time, time);
+        while (t < sampleTime) {
+            float dt = (float)std::min((double)step, sampleTime - t);
+            oil.temperature =
+                oilTemperature + slope * (float)(t + 0.5 * dt - time);
+            stepEnd = t + dt;
+            basket->fry.update(dt, oil.temperature, HEADLESS_OIL_SURFACE_Y,
+                               oil.getDensity(), HEADLESS_BASKET_BOTTOM_Y);
+            t += dt;
+        }
+        // A basket stamped after this sample isn't moved back to it
+        basket->time = std::max(basket->time, sampleTime);
+    }
+}
+
+void DigitalTwin::predict(TwinBasket& basket) {
+    if (basket.doneTime >= 0.0f) {
+        basket.predictedDone = basket.doneTime;
+        return;
+    }
+
+    TemperatureSchedule schedule;
+    schedule.switchTimes = {0.0f};
+    schedule.targets = {setPoint > 0.0f ? setPoint : oilTemperature};
+    RolloutResult result = rolloutFry(
+        basket.fry, Oil(HEADLESS_OIL_SURFACE_Y, oilTemperature), schedule,
+        HEADLESS_BASKET_BOTTOM_Y, horizon, step);
+
+    basket.predictedDone =
+        result.doneTime >= 0.0f ? basket.time + result.doneTime : -1.0f;
+    basket.predictions.push_back({time, basket.predictedDone});
+}
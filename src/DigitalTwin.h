@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Oil.h"
+#include "Potato.h"
+#include "Rollout.h"
+#include "SensorFeed.h"
+
+/**
+ * A basket in the real fryer, mirrored by a representative fry. predictions
+ * holds every (sensor time, predicted DONE time) pair while the basket is
+ * in; at the lift they are reduced to leadErrors, one per LEAD_TIMES entry,
+ * and dropped.
+ */
+struct TwinBasket {
+    static const int NUM_LEADS = 3;
+    static constexpr float LEAD_TIMES[NUM_LEADS] = {120.0f, 60.0f, 30.0f};
+
+    TwinBasket(int id, double dropTime);
+
+    // Fills leadErrors and releases predictions
+    void summarize();
+
+    int id;
+    Potato fry;
+    double dropTime;       // s, sensor time
+    double time;           // s, sensor time the fry state is assimilated to
+    double doneTime;       // s, -1 until the fry reaches DONE
+    double predictedDone;  // s, -1 if not expected within the horizon
+    std::vector<std::pair<double, double>> predictions;
+    float leadErrors[NUM_LEADS];  // s, NAN where there is none
+
+    // Prediction made at least leadTime before DONE, minus the actual DONE
+    // time; NAN if there is none
+    float getPredictionError(float leadTime) const;
+};
+
+/**
+ * Digital twin of a fryer driven by its oil thermocouple. Simulation time is
+ * the sensor's timeline: each new sample advances every basket's fry only
+ * over the interval since the previous sample, with the oil temperature
+ * interpolated between the two readings, so assimilating a sample costs a
+ * few fry steps however long the basket has been in. Each basket's DONE
+ * time is then re-forecast by a rollout from its current state with the
+ * oil starting at the latest reading and approaching the set point (or
+ * holding the reading if no set point has been reported). A set point
+ * change is picked up by the next sample's forecasts rather than costing a
+ * rollout per basket of its own. Sensor times are double, as feeds run for
+ * hours.
+ */
+class DigitalTwin {
+   public:
+    DigitalTwin();
+    DigitalTwin(const DigitalTwin&) = delete;
+    DigitalTwin& operator=(const DigitalTwin&) = delete;
+
+    void apply(const SensorMessage& message);
+
+    const TwinBasket* findBasket(int id) const;
+
+    double time;           // s, latest sample
+    float oilTemperature;  // °C, latest sample
+    float setPoint;        // °C, -1 if unknown
+    bool hasSample;
+    std::vector<std::unique_ptr<TwinBasket>> baskets;
+    std::vector<std::unique_ptr<TwinBasket>> lifted;  // Oldest first
+
+    int maxLifted;  // Lifted baskets kept for findBasket
+
+    float step;     // s, fry step for assimilation and prediction
+    float horizon;  // s, how far ahead a forecast looks for DONE
+
+   private:
+    void assimilate(double sampleTime, float sampleTemperature);
+    void predict(TwinBasket& basket);
+
+    Oil oil;
+    double stepEnd;  // Sensor time at the end of the fry step being taken
+};
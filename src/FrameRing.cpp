@@ -0,0 +1,155 @@
+#include "FrameRing.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <new>
+
+#include "ofMain.h"
+
+namespace {
+
+const uint32_t RING_MAGIC = 0x46525947;  // "FRYG"
+const uint32_t RING_VERSION = 2;
+
+}  // namespace
+
+std::string FrameRing::getName(int fryer) {
+    return "/deepfry-fryer-" + std::to_string(fryer);
+}
+
+FrameRing::FrameRing()
+    : header(nullptr), mappedSize(0), owner(false), writeSequence(0) {}
+
+FrameRing::~FrameRing() { close(); }
+
+bool FrameRing::create(const std::string& segmentName) {
+    close();
+
+    // A segment left by a crashed publisher can't be resized on every
+    // platform; always start from a fresh one
+    shm_unlink(segmentName.c_str());
+    int fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        ofLogError("FrameRing") << "cannot create " << segmentName;
+        return false;
+    }
+
+    size_t size = sizeof(Header);
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, size) == 0) {
+        memory =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        ofLogError("FrameRing") << "cannot map " << segmentName;
+        shm_unlink(segmentName.c_str());
+        return false;
+    }
+
+    header = new (memory) Header;
+    header->version = RING_VERSION;
+    header->frameSize = sizeof(FrameSnapshot);
+    header->latest.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < NUM_SLOTS; i++) {
+        header->slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = RING_MAGIC;
+
+    mappedSize = size;
+    name = segmentName;
+    owner = true;
+    writeSequence = 0;
+    return true;
+}
+
+bool FrameRing::attach(const std::string& segmentName) {
+    close();
+
+    int fd = shm_open(segmentName.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(Header)) {
+        memory = mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) return false;
+
+    // Reject segments still being initialized or from another build
+    Header* mapped = static_cast<Header*>(memory);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (mapped->magic != RING_MAGIC || mapped->version != RING_VERSION ||
+        mapped->frameSize != sizeof(FrameSnapshot)) {
+        munmap(memory, sizeof(Header));
+        return false;
+    }
+
+    header = mapped;
+    mappedSize = sizeof(Header);
+    name = segmentName;
+    owner = false;
+    return true;
+}
+
+void FrameRing::close() {
+    if (header == nullptr) return;
+    munmap(header, mappedSize);
+    if (owner) shm_unlink(name.c_str());
+    header = nullptr;
+    mappedSize = 0;
+    owner = false;
+}
+
+bool FrameRing::isOpen() const { return header != nullptr; }
+
+FrameSnapshot* FrameRing::beginWrite() {
+    if (header == nullptr || !owner) return nullptr;
+
+    // Odd while being written; the fence keeps the frame's stores after it
+    writeSequence++;
+    Slot& slot = header->slots[writeSequence % NUM_SLOTS];
+    slot.sequence.store(2 * writeSequence - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return &slot.frame;
+}
+
+void FrameRing::endWrite() {
+    if (header == nullptr || !owner) return;
+    Slot& slot = header->slots[writeSequence % NUM_SLOTS];
+    slot.sequence.store(2 * writeSequence, std::memory_order_release);
+    header->latest.store(writeSequence, std::memory_order_release);
+}
+
+uint64_t FrameRing::readLatest(FrameSnapshot& out) const {
+    if (header == nullptr) return 0;
+
+    uint64_t latest = header->latest.load(std::memory_order_acquire);
+    for (int back = 0; back < NUM_SLOTS - 1 && back < (int)latest; back++) {
+        if (readFrame(latest - back, out)) return latest - back;
+    }
+    return 0;
+}
+
+bool FrameRing::readFrame(uint64_t n, FrameSnapshot& out) const {
+    if (header == nullptr || n == 0) return false;
+
+    const Slot& slot = header->slots[n % NUM_SLOTS];
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before != 2 * n) return false;
+
+    std::memcpy(&out, &slot.frame, sizeof(FrameSnapshot));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == before;
+}
+
+uint64_t FrameRing::getLatestSequence() const {
+    if (header == nullptr) return 0;
+    return header->latest.load(std::memory_order_acquire);
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * One published simulation frame: everything the viewer draws, as
+ * fixed-capacity structure-of-arrays so it can live directly in shared
+ * memory. Fries index the single fry first (when hasSingleFry) and then the
+ * basket. Counts are clamped to the capacities by the publisher.
+ */
+struct FrameSnapshot {
+    static const int MAX_FRIES = 128;
+    static const int MAX_BUBBLES = 2048;
+    static const int MAX_STEAM = 1024;
+    static const int MAX_SPLATTER = 512;
+    static const int MAX_FIELD_CELLS = 96 * 48;
+    static const int MAX_WAVE_CELLS = 2048;
+    static const int PERIMETER_SEGMENTS = 32;
+
+    // Scene
+    float simTime;  // s
+    float oilTemperature;
+    float targetTemperature;
+    float polarCompounds;
+    float fryEventTimes[3];  // by FryEvent::Type, -1 if unseen
+    uint8_t mpcEnabled;
+    uint8_t isPaused;
+    uint8_t hasSingleFry;
+    uint8_t fryInOil;
+
+    // Fries
+    int numFries;
+    float fryX[MAX_FRIES];
+    float fryY[MAX_FRIES];
+    float fryWidth[MAX_FRIES];
+    float fryHeight[MAX_FRIES];
+    float fryTemperature[MAX_FRIES];
+    float fryDensity[MAX_FRIES];
+    float fryMoisture[MAX_FRIES];
+    float fryCookedness[MAX_FRIES];
+    float fryCrust[MAX_FRIES];
+    float fryTimeInOil[MAX_FRIES];
+    float frySurfaceTemperature[MAX_FRIES];
+    float fryCoreTemperature[MAX_FRIES];
+    uint32_t fryColor[MAX_FRIES];  // 0xRRGGBBAA
+    uint8_t fryInOilFlag[MAX_FRIES];
+    uint8_t fryResolved[MAX_FRIES];
+    float segmentCrust[PERIMETER_SEGMENTS][MAX_FRIES];
+
+    // Discrete bubbles
+    int numBubbles;
+    uint32_t bubbleId[MAX_BUBBLES];
+    float bubbleX[MAX_BUBBLES];
+    float bubbleY[MAX_BUBBLES];
+    float bubbleVx[MAX_BUBBLES];
+    float bubbleVy[MAX_BUBBLES];
+    float bubbleSize[MAX_BUBBLES];
+    float bubbleLife[MAX_BUBBLES];
+    float bubbleWobble[MAX_BUBBLES];
+    uint32_t bubbleColor[MAX_BUBBLES];  // 0xRRGGBBAA
+    uint8_t bubbleType[MAX_BUBBLES];
+    uint8_t bubbleSurfaced[MAX_BUBBLES];
+
+    // Above-surface particles
+    int numSteam;
+    float steamX[MAX_STEAM];
+    float steamY[MAX_STEAM];
+    float steamSize[MAX_STEAM];
+    float steamAge[MAX_STEAM];
+    float steamLifespan[MAX_STEAM];
+    int numSplatter;
+    float splatterX[MAX_SPLATTER];
+    float splatterY[MAX_SPLATTER];
+    float splatterSize[MAX_SPLATTER];
+
+    // Grids
+    int numFieldCells;
+    float fieldDensity[MAX_FIELD_CELLS];
+    int numWaveCells;
+    float waveHeight[MAX_WAVE_CELLS];
+};
+
+/**
+ * Single-writer, multi-reader ring of FrameSnapshots in POSIX shared
+ * memory, so a headless simulation can publish every frame while viewer
+ * processes attach and detach at will.
+ *
+ * Each slot carries a sequence counter (seqlock): the writer marks the slot
+ * odd while filling it and stores 2n when frame n is complete, then
+ * advances the ring's latest counter. Readers copy a slot and re-check its
+ * counter, falling back to older slots if the writer lapped them. The
+ * writer never waits on a reader; a reader that keeps getting lapped only
+ * sees an older frame.
+ *
+ * The publisher replaces any segment left behind under the same name, so
+ * attached viewers notice a restarted publisher only by its frames going
+ * stale and re-attach.
+ */
+class FrameRing {
+   public:
+    static const int NUM_SLOTS = 4;
+
+    // Segment name for fryer n, e.g. "/deepfry-fryer-0"
+    static std::string getName(int fryer);
+
+    FrameRing();
+    ~FrameRing();
+
+    bool create(const std::string& name);  // Publisher, read-write
+    bool attach(const std::string& name);  // Viewer, read-only
+    void close();
+    bool isOpen() const;
+
+    // Publisher: fill the returned frame in place between the two calls
+    FrameSnapshot* beginWrite();
+    void endWrite();
+
+    // Copies the newest complete frame into out and returns its sequence
+    // number, or 0 if nothing consistent could be read
+    uint64_t readLatest(FrameSnapshot& out) const;
+
+    // Copies frame n (sequence number) if it is still in the ring intact
+    bool readFrame(uint64_t n, FrameSnapshot& out) const;
+    uint64_t getLatestSequence() const;
+
+   private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence;
+        FrameSnapshot frame;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t frameSize;
+        alignas(64) std::atomic<uint64_t> latest;
+        Slot slots[NUM_SLOTS];
+    };
+
+    Header* header;
+    size_t mappedSize;
+    std::string name;
+    bool owner;
+    uint64_t writeSequence;
+};
@@ -0,0 +1,59 @@
+#include "FryGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+FryGrid::FryGrid(float left, float top, float right, float bottom,
+                 float cellSize)
+    : left(left), top(top), cellSize(cellSize) {
+    cols = std::max(1, (int)ceil((right - left) / cellSize));
+    rows = std::max(1, (int)ceil((bottom - top) / cellSize));
+    cells.resize(cols * rows);
+}
+
+void FryGrid::clear() {
+    for (auto& cell : cells) cell.clear();
+}
+
+void FryGrid::insert(int id, const ofRectangle& bounds) {
+    // Fries past the edges (still falling in, or dragged out) are kept in
+    // the border cells
+    int col0 = getCol(bounds.getLeft());
+    int col1 = getCol(bounds.getRight());
+    int row0 = getRow(bounds.getTop());
+    int row1 = getRow(bounds.getBottom());
+    for (int row = row0; row <= row1; row++) {
+        for (int col = col0; col <= col1; col++) {
+            cells[row * cols + col].push_back(id);
+        }
+    }
+}
+
+const std::vector<int>& FryGrid::getCandidates(ofVec2f point) const {
+    return cells[getRow(point.y) * cols + getCol(point.x)];
+}
+
+void FryGrid::getCandidates(const ofRectangle& area,
+                            std::vector<int>& ids) const {
+    ids.clear();
+    int col0 = getCol(area.getLeft());
+    int col1 = getCol(area.getRight());
+    int row0 = getRow(area.getTop());
+    int row1 = getRow(area.getBottom());
+    for (int row = row0; row <= row1; row++) {
+        for (int col = col0; col <= col1; col++) {
+            const std::vector<int>& cell = cells[row * cols + col];
+            ids.insert(ids.end(), cell.begin(), cell.end());
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+int FryGrid::getCol(float x) const {
+    return std::min(std::max((int)floor((x - left) / cellSize), 0), cols - 1);
+}
+
+int FryGrid::getRow(float y) const {
+    return std::min(std::max((int)floor((y - top) / cellSize), 0), rows - 1);
+}
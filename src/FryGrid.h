@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "ofMain.h"
+
+/**
+ * Uniform grid of fry bounding rectangles for picking. Each fry id is
+ * listed in every cell its rectangle overlaps, so a point query only looks
+ * at the few fries sharing the point's cell and a rectangle query only at
+ * the cells it covers, however many fries are on screen. Rebuilt from
+ * scratch whenever the fries move; cells keep their storage across
+ * rebuilds.
+ */
+class FryGrid {
+   public:
+    FryGrid(float left, float top, float right, float bottom,
+            float cellSize = 32.0f);
+
+    void clear();
+    void insert(int id, const ofRectangle& bounds);
+
+    // Every id whose rectangle overlaps the cell containing point
+    const std::vector<int>& getCandidates(ofVec2f point) const;
+
+    // Every id whose rectangle overlaps area's cells, each listed once
+    void getCandidates(const ofRectangle& area, std::vector<int>& ids) const;
+
+    int cols;
+    int rows;
+
+   private:
+    int getCol(float x) const;
+    int getRow(float y) const;
+
+    float left;
+    float top;
+    float cellSize;
+    std::vector<std::vector<int>> cells;  // Row-major
+};
@@ -0,0 +1,196 @@
+#include "FryerDay.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Rollout.h"
+
+namespace {
+
+const float POTATO_SPECIFIC_HEAT = 3500.0f;  // J/kg·K
+const float LATENT_HEAT = 2.257e6f;          // J/kg
+
+}  // namespace
+
+float stepFryer(Oil& oil, Potato* fry, const FryerDayConfig& config,
+                float dt) {
+    return stepFryer(oil, fry, fry != nullptr ? 1 : 0, config, dt);
+}
+
+float stepFryer(Oil& oil, Potato* fries, int numFries,
+                const FryerDayConfig& config, float dt) {
+    float totalArea = 0.0f;
+    for (int i = 0; i < numFries; i++) {
+        totalArea += fries[i].size.x * fries[i].size.y;
+    }
+
+    // Every fry sees the oil as it was at the start of the step
+    float oilTemperature = oil.temperature;
+    float oilDensity = oil.getDensity();
+    float waterReleased = 0.0f;
+    float load = 0.0f;
+    for (int i = 0; i < numFries; i++) {
+        Potato& fry = fries[i];
+        float startTemperature = fry.temperature;
+        float startMoisture = fry.moistureContent;
+        fry.update(dt, oilTemperature, HEADLESS_OIL_SURFACE_Y, oilDensity,
+                   HEADLESS_BASKET_BOTTOM_Y);
+
+        // Drawn by share of the basket's mass (cut area, all fries being
+        // the same depth)
+        float mass = config.basketMass * fry.size.x * fry.size.y / totalArea;
+        load += getFryHeatLoad(fry, mass, startTemperature, startMoisture);
+        waterReleased +=
+            mass * std::max(0.0f, startMoisture - fry.moistureContent);
+    }
+    float heat = exchangeOilHeat(oil, load, config, dt);
+
+    oil.degrade(dt, waterReleased);
+    return heat;
+}
+
+float getFryHeatLoad(const Potato& fry, float mass, float startTemperature,
+                     float startMoisture) {
+    // Sensible heat of warming plus latent heat of the water driven off
+    float heating = std::max(0.0f, fry.temperature - startTemperature);
+    float water = mass * std::max(0.0f, startMoisture - fry.moistureContent);
+    return mass * POTATO_SPECIFIC_HEAT * heating + water * LATENT_HEAT;
+}
+
+float exchangeOilHeat(Oil& oil, float load, const FryerDayConfig& config,
+                      float dt) {
+    oil.temperature -= load / config.oilHeatCapacity;
+
+    // Thermostat: full power below the set point, never overshooting it
+    float deficit =
+        std::max(0.0f, config.setPoint - oil.temperature) *
+        config.oilHeatCapacity;
+    float heat = std::min(config.heaterPower * dt, deficit);
+    oil.temperature += heat / config.oilHeatCapacity;
+    return heat;
+}
+
+FryerDayConfig::FryerDayConfig() {
+    // 12-hour service with lunch and dinner peaks, same fryer as KitchenSim
+    hourlyBaskets = {8, 15, 30, 26, 12, 8, 10, 20, 32, 28, 15, 6};
+    setPoint = 175.0f;
+    readyTolerance = 5.0f;
+    basketMass = 0.6f;
+    heaterPower = 14000.0f;
+    oilHeatCapacity = 30000.0f;
+    basketHandlingTime = 15.0f;
+    initialPolarCompounds = 4.0f;
+}
+
+std::vector<float> getDemandTimes(const FryerDayConfig& config) {
+    std::vector<float> times;
+    for (size_t hour = 0; hour < config.hourlyBaskets.size(); hour++) {
+        int count = (int)round(config.hourlyBaskets[hour]);
+        for (int k = 0; k < count; k++) {
+            times.push_back((hour + (k + 0.5f) / count) * 3600.0f);
+        }
+    }
+    return times;
+}
+
+BasketCycle simulateBasketCycle(const FryerDayConfig& config,
+                                float dropTemperature, float dt) {
+    Oil oil(HEADLESS_OIL_SURFACE_Y, dropTemperature);
+    oil.polarCompounds = 0.0f;
+
+    Potato fry = makeDroppedFry(HEADLESS_OIL_SURFACE_Y, 1);
+    bool done = false;
+    fry.onEvent = [&](const FryEvent& event) {
+        if (event.type == FryEvent::DONE) done = true;
+    };
+
+    BasketCycle cycle;
+    cycle.cookTime = 0.0f;
+    cycle.heaterEnergy = 0.0f;
+    cycle.minOilTemperature = dropTemperature;
+
+    const float maxCookTime = 600.0f;
+    while (!done && cycle.cookTime < maxCookTime) {
+        cycle.heaterEnergy += stepFryer(oil, &fry, config, dt);
+        cycle.minOilTemperature =
+            std::min(cycle.minOilTemperature, oil.temperature);
+        cycle.cookTime += dt;
+    }
+
+    cycle.liftTemperature = oil.temperature;
+    cycle.polarCompoundsAdded = oil.polarCompounds;
+    return cycle;
+}
+
+FryerDayResult simulateFryerDay(const FryerDayConfig& config, float dt) {
+    std::vector<float> demandTimes = getDemandTimes(config);
+    float serviceEnd = config.hourlyBaskets.size() * 3600.0f;
+    // Hard stop well past close in case demand outstrips the fryer
+    float hardStop = serviceEnd + 4.0f * 3600.0f;
+
+    Oil oil(HEADLESS_OIL_SURFACE_Y, config.setPoint);
+    oil.polarCompounds = config.initialPolarCompounds;
+
+    FryerDayResult result;
+    result.basketsDemanded = (int)demandTimes.size();
+    result.basketsCooked = 0;
+    result.heaterEnergy = 0.0f;
+    result.minOilTemperature = config.setPoint;
+
+    Potato fry = makeDroppedFry(HEADLESS_OIL_SURFACE_Y, 0);
+    bool basketIn = false;
+    bool done = false;
+    fry.onEvent = [&](const FryEvent& event) {
+        if (event.type == FryEvent::DONE) done = true;
+    };
+
+    size_t nextDemand = 0;
+    int queued = 0;
+    float handledAt = 0.0f;
+    float cookStart = 0.0f;
+    float totalCookTime = 0.0f;
+    float t = 0.0f;
+
+    while (t < hardStop) {
+        while (nextDemand < demandTimes.size() &&
+               demandTimes[nextDemand] <= t) {
+            queued++;
+            nextDemand++;
+        }
+        if (!basketIn && queued == 0 && nextDemand == demandTimes.size() &&
+            t >= serviceEnd) {
+            break;
+        }
+
+        if (!basketIn && queued > 0 && t >= handledAt &&
+            oil.temperature >= config.setPoint - config.readyTolerance) {
+            auto onEvent = fry.onEvent;
+            fry = makeDroppedFry(HEADLESS_OIL_SURFACE_Y,
+                                 result.basketsCooked + 1);
+            fry.onEvent = onEvent;
+            basketIn = true;
+            done = false;
+            cookStart = t;
+            queued--;
+        }
+
+        result.heaterEnergy +=
+            stepFryer(oil, basketIn ? &fry : nullptr, config, dt);
+        result.minOilTemperature =
+            std::min(result.minOilTemperature, oil.temperature);
+        t += dt;
+
+        if (basketIn && done) {
+            basketIn = false;
+            result.basketsCooked++;
+            totalCookTime += t - cookStart;
+            handledAt = t + config.basketHandlingTime;
+        }
+    }
+
+    result.polarCompounds = oil.polarCompounds;
+    result.meanCookTime =
+        result.basketsCooked > 0 ? totalCookTime / result.basketsCooked : 0.0f;
+    result.endTime = t;
+    return result;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+
+#include "Oil.h"
+#include "Potato.h"
+
+/**
+ * One fryer over a service day. Baskets are demanded at an even spacing
+ * within each hour, queue while the fryer is busy, and are dropped once the
+ * basket has been handled and the oil is back within readyTolerance of the
+ * set point. Service continues after close until the queue is empty.
+ */
+struct FryerDayConfig {
+    FryerDayConfig();
+
+    std::vector<float> hourlyBaskets;  // baskets demanded per hour
+    float setPoint;                    // °C
+    float readyTolerance;              // °C
+    float basketMass;                  // kg of fries
+    float heaterPower;                 // W
+    float oilHeatCapacity;             // J/°C
+    float basketHandlingTime;          // s
+    float initialPolarCompounds;       // % TPC
+};
+
+struct FryerDayResult {
+    int basketsDemanded;
+    int basketsCooked;
+    float heaterEnergy;       // J
+    float polarCompounds;     // % TPC at end of service
+    float meanCookTime;       // s
+    float minOilTemperature;  // °C
+    float endTime;            // s, last basket lifted or close
+};
+
+/**
+ * Full-physics basket cycle: the basket is a representative fry scaled to
+ * basketMass, stepped together with the oil. The fry's sensible and latent
+ * heat is drawn from the oil each step, the thermostat heater refills it up
+ * to the set point, and the released water feeds oil degradation. Ends at
+ * the fry's DONE event.
+ */
+struct BasketCycle {
+    float cookTime;            // s
+    float liftTemperature;     // °C
+    float minOilTemperature;   // °C
+    float heaterEnergy;        // J
+    float polarCompoundsAdded; // % TPC
+};
+
+/**
+ * Advances the oil, and the basket fry if present, by dt: the basket draws
+ * its heat load from the oil and the thermostat refills it. Returns the
+ * heater energy spent (J) and accumulates oil degradation.
+ */
+float stepFryer(Oil& oil, Potato* fry, const FryerDayConfig& config,
+                float dt);
+
+// Same, for a basket of numFries sharing basketMass by cut area
+float stepFryer(Oil& oil, Potato* fries, int numFries,
+                const FryerDayConfig& config, float dt);
+
+// Heat (J) a fry of mass kg drew from the oil since it was at
+// startTemperature and startMoisture: sensible plus latent
+float getFryHeatLoad(const Potato& fry, float mass, float startTemperature,
+                     float startMoisture);
+
+// Draws load (J) from the oil, then runs the thermostat heater for dt up to
+// the set point. Returns the heater energy spent (J).
+float exchangeOilHeat(Oil& oil, float load, const FryerDayConfig& config,
+                      float dt);
+
+BasketCycle simulateBasketCycle(const FryerDayConfig& config,
+                                float dropTemperature, float dt);
+
+/**
+ * Full-physics reference day: the oil is time-stepped throughout and every
+ * basket runs the coupled cycle above. Used to fit and validate
+ * ReducedFryerModel.
+ */
+FryerDayResult simulateFryerDay(const FryerDayConfig& config, float dt);
+
+std::vector<float> getDemandTimes(const FryerDayConfig& config);
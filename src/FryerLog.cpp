@@ -0,0 +1,253 @@
+#include "FryerLog.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "ofMain.h"
+
+namespace {
+
+const char BINARY_MAGIC[8] = {'F', 'R', 'Y', 'L', 'O', 'G', '1', '\n'};
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t recordSize;
+    uint32_t reserved;
+};
+
+// Field [start, end) of a mapped CSV row as a number. Mapped text has no
+// terminator, so the field is copied out before strtod sees it.
+double parseField(const char* start, const char* end) {
+    char text[32];
+    size_t length = std::min((size_t)(end - start), sizeof(text) - 1);
+    memcpy(text, start, length);
+    text[length] = '\0';
+    return std::strtod(text, nullptr);
+}
+
+int findColumn(const std::vector<std::string>& header, const char* name) {
+    for (size_t i = 0; i < header.size(); i++) {
+        if (header[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+}  // namespace
+
+FryerLog::FryerLog()
+    : data(nullptr),
+      size(0),
+      binary(false),
+      firstRecord(0),
+      numColumns(0),
+      runColumn(-1),
+      timeColumn(-1),
+      oilColumn(-1),
+      setPointColumn(-1),
+      friesColumn(-1) {}
+
+FryerLog::~FryerLog() { close(); }
+
+bool FryerLog::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) fd = ::open(ofToDataPath(path).c_str(), O_RDONLY);
+    if (fd < 0) {
+        ofLogError("FryerLog") << "cannot open " << path;
+        return false;
+    }
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        memory = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        ofLogError("FryerLog") << "cannot map " << path;
+        return false;
+    }
+    data = static_cast<const char*>(memory);
+    size = info.st_size;
+
+    // Logs are read front to back once per cursor
+    madvise(memory, size, MADV_SEQUENTIAL);
+
+    BinaryHeader header;
+    if (size >= sizeof(header)) memcpy(&header, data, sizeof(header));
+    if (size >= sizeof(header) &&
+        memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+        if (header.recordSize != sizeof(LogSample)) {
+            ofLogError("FryerLog") << path << " is from another build";
+            close();
+            return false;
+        }
+        binary = true;
+        firstRecord = sizeof(header);
+        return true;
+    }
+
+    const char* end = data + size;
+    const char* lineEnd = (const char*)memchr(data, '\n', size);
+    if (lineEnd == nullptr) lineEnd = end;
+    std::vector<std::string> columns;
+    const char* field = data;
+    for (const char* c = data; c <= lineEnd; c++) {
+        if (c == lineEnd || *c == ',') {
+            std::string name(field, c);
+            if (!name.empty() && name.back() == '\r') name.pop_back();
+            columns.push_back(name);
+            field = c + 1;
+        }
+    }
+    if ((int)columns.size() > MAX_COLUMNS) {
+        ofLogError("FryerLog") << path << " has " << columns.size()
+                               << " columns, more than " << MAX_COLUMNS;
+        close();
+        return false;
+    }
+    numColumns = columns.size();
+    runColumn = findColumn(columns, "run");
+    timeColumn = findColumn(columns, "time");
+    oilColumn = findColumn(columns, "oil_temperature");
+    setPointColumn = findColumn(columns, "set_point");
+    friesColumn = findColumn(columns, "fries");
+    if (timeColumn < 0 || oilColumn < 0) {
+        ofLogError("FryerLog")
+            << path << " has no time and oil_temperature columns";
+        close();
+        return false;
+    }
+    firstRecord = std::min((size_t)(lineEnd - data) + 1, size);
+    return true;
+}
+
+void FryerLog::close() {
+    if (data != nullptr) munmap((void*)data, size);
+    data = nullptr;
+    size = 0;
+    binary = false;
+    firstRecord = 0;
+    numColumns = 0;
+    runColumn = timeColumn = oilColumn = setPointColumn = friesColumn = -1;
+}
+
+bool FryerLog::writeBinary(const std::string& path) const {
+    FILE* out = fopen(path.c_str(), "wb");
+    if (out == nullptr) {
+        ofLogError("FryerLog") << "cannot write " << path;
+        return false;
+    }
+    BinaryHeader header = {};
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.recordSize = sizeof(LogSample);
+    fwrite(&header, sizeof(header), 1, out);
+
+    FryerLogCursor cursor(*this);
+    while (cursor.advance()) {
+        fwrite(&cursor.getCurrent(), sizeof(LogSample), 1, out);
+    }
+    return fclose(out) == 0;
+}
+
+FryerLogCursor::FryerLogCursor(const FryerLog& log)
+    : log(&log),
+      offset(log.firstRecord),
+      previous(),
+      current(),
+      started(false),
+      atEnd(false),
+      run(0.0f),
+      runOffset(0.0),
+      lastRawTime(0.0),
+      lastInterval(0.0) {}
+
+bool FryerLogCursor::advance() {
+    LogSample sample;
+    if (log->binary) {
+        if (offset + sizeof(sample) > log->size) {
+            atEnd = true;
+            return false;
+        }
+        memcpy(&sample, log->data + offset, sizeof(sample));
+        offset += sizeof(sample);
+    } else if (!readCsvRow(sample)) {
+        atEnd = true;
+        return false;
+    }
+
+    previous = started ? current : sample;
+    current = sample;
+    started = true;
+    return true;
+}
+
+float FryerLogCursor::getTemperature(double time) {
+    if (!started && !advance()) return 0.0f;
+    while (current.time < time && advance()) {
+    }
+    if (time >= current.time || current.time <= previous.time) {
+        return current.oilTemperature;
+    }
+    if (time <= previous.time) return previous.oilTemperature;
+    float u = (float)((time - previous.time) /
+                      (current.time - previous.time));
+    return previous.oilTemperature +
+           u * (current.oilTemperature - previous.oilTemperature);
+}
+
+bool FryerLogCursor::readCsvRow(LogSample& sample) {
+    const char* end = log->data + log->size;
+    while (offset < log->size) {
+        const char* row = log->data + offset;
+        const char* rowEnd = (const char*)memchr(row, '\n', end - row);
+        if (rowEnd == nullptr) rowEnd = end;
+        offset = rowEnd - log->data + 1;
+
+        // Split in place; short or blank rows are skipped
+        const char* fields[FryerLog::MAX_COLUMNS];
+        const char* fieldEnds[FryerLog::MAX_COLUMNS];
+        int numFields = 0;
+        const char* field = row;
+        for (const char* c = row;
+             c <= rowEnd && numFields < FryerLog::MAX_COLUMNS; c++) {
+            if (c == rowEnd || *c == ',') {
+                fields[numFields] = field;
+                fieldEnds[numFields++] = c;
+                field = c + 1;
+            }
+        }
+        if (numFields < log->numColumns) continue;
+
+        auto get = [&](int column) {
+            return parseField(fields[column], fieldEnds[column]);
+        };
+        double rawTime = get(log->timeColumn);
+        float rowRun = log->runColumn >= 0 ? get(log->runColumn) : 0.0f;
+        if (!started) {
+            run = rowRun;
+        } else if (rowRun != run) {
+            runOffset += lastRawTime + lastInterval - rawTime;
+            run = rowRun;
+        } else {
+            lastInterval = rawTime - lastRawTime;
+        }
+        lastRawTime = rawTime;
+
+        sample.time = rawTime + runOffset;
+        sample.oilTemperature = get(log->oilColumn);
+        sample.setPoint =
+            log->setPointColumn >= 0 ? get(log->setPointColumn) : -1.0f;
+        sample.fries = log->friesColumn >= 0 ? get(log->friesColumn) : 0.0f;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * One logged fryer reading. Times are seconds on the log's timeline, in
+ * double so readings hours into a log keep sub-millisecond spacing.
+ */
+struct LogSample {
+    double time;
+    float oilTemperature;  // °C
+    float setPoint;        // °C, -1 if the log has none
+    float fries;           // Fries in the oil; 0 while no basket is in
+};
+
+/**
+ * A recorded fryer log mapped read-only into memory, so a log of any
+ * length opens instantly and is paged in only as cursors stream through
+ * it. Two formats are read:
+ *
+ *   CSV     header row with time and oil_temperature columns, optionally
+ *           set_point and fries (a scenario recording is one), and at most
+ *           MAX_COLUMNS columns. Runs in a run column are laid end to end
+ *           on one timeline.
+ *   binary  the "FRYLOG" header followed by packed LogSample records, as
+ *           written by writeBinary; several times smaller and parse-free
+ *
+ * A FryerLog only owns the mapping; reading goes through FryerLogCursor,
+ * any number of which may stream one log concurrently.
+ */
+class FryerLog {
+   public:
+    static const int MAX_COLUMNS = 64;
+
+    FryerLog();
+    ~FryerLog();
+    FryerLog(const FryerLog&) = delete;
+    FryerLog& operator=(const FryerLog&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+
+    // Streams every sample of this log into a binary log at path
+    bool writeBinary(const std::string& path) const;
+
+    const char* data;
+    size_t size;
+    bool binary;
+    size_t firstRecord;  // Byte offset of the first sample
+
+    // CSV column indices, -1 if absent
+    int numColumns;
+    int runColumn;
+    int timeColumn;
+    int oilColumn;
+    int setPointColumn;
+    int friesColumn;
+};
+
+/**
+ * Forward-streaming read position in a FryerLog. Cursors are small and
+ * copyable: copying one mid-log gives an independent cursor that resumes
+ * from the same sample.
+ */
+class FryerLogCursor {
+   public:
+    explicit FryerLogCursor(const FryerLog& log);
+
+    // Moves to the next sample; false at the end of the log
+    bool advance();
+
+    // The sample advance last moved to
+    const LogSample& getCurrent() const { return current; }
+
+    // Latest sample at or before time, of the two getTemperature last used
+    const LogSample& getSampleBefore(double time) const {
+        return current.time <= time ? current : previous;
+    }
+
+    // Oil temperature at time, linearly interpolated between the samples
+    // around it. Advances as needed, so times are expected to increase;
+    // earlier times and times past the end hold the nearest sample.
+    float getTemperature(double time);
+
+    bool isAtEnd() const { return atEnd; }
+
+   private:
+    bool readCsvRow(LogSample& sample);
+
+    const FryerLog* log;
+    size_t offset;
+    LogSample previous;
+    LogSample current;
+    bool started;
+    bool atEnd;
+
+    // CSV runs are shifted to follow the previous run's last sample
+    float run;
+    double runOffset;
+    double lastRawTime;
+    double lastInterval;
+};
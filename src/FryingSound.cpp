@@ -0,0 +1,246 @@
+#include "FryingSound.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Bubble::size is a radius in pixels; the scene is roughly 0.15 mm/px
+const float METRES_PER_PIXEL = 0.00015f;
+
+// Minnaert resonance f = (1 / 2πR) sqrt(3γp/ρ), ≈ 3.26 m·Hz / R for vapour
+// in a light liquid at atmospheric pressure
+const float MINNAERT_CONSTANT = 3.26f;
+
+const float SILENCE = 1e-3f;
+const float PI_F = 3.14159265f;
+
+}  // namespace
+
+BubbleSoundEvent makeBubbleSoundEvent(const Bubble& bubble, float time,
+                                      float oilLeft, float oilRight) {
+    BubbleSoundEvent event;
+    event.time = time;
+    event.bubbleType = bubble.bubbleType;
+    event.size = bubble.size;
+    event.pan = ofMap(bubble.position.x, oilLeft, oilRight, -1, 1, true);
+    return event;
+}
+
+FryingSound::FryingSound(float rate) {
+    sampleRate = rate;
+    masterGain = 0.5f;
+    droppedEvents = 0;
+    numVoices = 0;
+    activeVoices = 0;
+    for (int i = 0; i < MAX_VOICES; i++) {
+        clearVoice(i);
+        noiseState[i] = 0x9E3779B9u * (i + 1);
+    }
+}
+
+bool FryingSound::post(const BubbleSoundEvent& event) {
+    if (events.push(event)) return true;
+    droppedEvents++;
+    return false;
+}
+
+void FryingSound::clearVoice(int voice) {
+    toneRe[voice] = 0;
+    toneIm[voice] = 0;
+    toneCos[voice] = 1;
+    toneSin[voice] = 0;
+    toneDecay[voice] = 0;
+    noiseLevel[voice] = 0;
+    noiseDecay[voice] = 0;
+    gainLeft[voice] = 0;
+    gainRight[voice] = 0;
+}
+
+void FryingSound::startVoice(const BubbleSoundEvent& event) {
+    int voice = numVoices;
+    if (voice == MAX_VOICES) {
+        // Steal the quietest voice
+        voice = 0;
+        float quietest = toneRe[0] * toneRe[0] + toneIm[0] * toneIm[0];
+        for (int i = 1; i < MAX_VOICES; i++) {
+            float energy = toneRe[i] * toneRe[i] + toneIm[i] * toneIm[i];
+            if (energy < quietest) {
+                quietest = energy;
+                voice = i;
+            }
+        }
+    } else {
+        numVoices++;
+    }
+
+    // Type-dependent timbre: ring time (s), tone level, rupture noise
+    float ringTime, level, noise, noiseTime, pitch;
+    if (event.bubbleType == 0) {
+        ringTime = 0.004f;
+        level = 0.25f;
+        noise = 0.6f;
+        noiseTime = 0.006f;
+        pitch = 1.0f;
+    } else if (event.bubbleType == 1) {
+        ringTime = 0.010f;
+        level = 0.15f;
+        noise = 0.15f;
+        noiseTime = 0.003f;
+        pitch = 1.2f;
+    } else {
+        ringTime = 0.030f;
+        level = 0.2f;
+        noise = 0.05f;
+        noiseTime = 0.002f;
+        pitch = 1.0f;
+    }
+
+    float radius = std::max(event.size, 0.5f) * METRES_PER_PIXEL;
+    float frequency = pitch * MINNAERT_CONSTANT / radius;
+    frequency = std::min(frequency, 0.45f * sampleRate);
+    float omega = 2.0f * PI_F * frequency / sampleRate;
+
+    // Starting at zero phase on the sine output avoids a click
+    toneRe[voice] = level;
+    toneIm[voice] = 0;
+    toneCos[voice] = cos(omega);
+    toneSin[voice] = sin(omega);
+    toneDecay[voice] = exp(-1.0f / (ringTime * sampleRate));
+    noiseLevel[voice] = noise;
+    noiseDecay[voice] = exp(-1.0f / (noiseTime * sampleRate));
+
+    // Constant-power pan
+    float angle = (std::max(-1.0f, std::min(1.0f, event.pan)) + 1.0f) *
+                  0.25f * PI_F;
+    gainLeft[voice] = cos(angle);
+    gainRight[voice] = sin(angle);
+}
+
+void FryingSound::mix(float* left, float* right, int numFrames) {
+    int paddedVoices =
+        (numVoices + VOICE_LANES - 1) / VOICE_LANES * VOICE_LANES;
+
+    std::fill(laneLeft[0], laneLeft[0] + numFrames * VOICE_LANES, 0.0f);
+    std::fill(laneRight[0], laneRight[0] + numFrames * VOICE_LANES, 0.0f);
+
+    // One lane group at a time, its state held in locals for the whole
+    // block; the inner lane loop is the SIMD dimension
+    for (int group = 0; group < paddedVoices; group += VOICE_LANES) {
+        float re[VOICE_LANES], im[VOICE_LANES], c[VOICE_LANES],
+            s[VOICE_LANES], decay[VOICE_LANES], level[VOICE_LANES],
+            levelDecay[VOICE_LANES], gl[VOICE_LANES], gr[VOICE_LANES];
+        uint32_t state[VOICE_LANES];
+        for (int lane = 0; lane < VOICE_LANES; lane++) {
+            int v = group + lane;
+            re[lane] = toneRe[v];
+            im[lane] = toneIm[v];
+            c[lane] = toneCos[v];
+            s[lane] = toneSin[v];
+            decay[lane] = toneDecay[v];
+            level[lane] = noiseLevel[v];
+            levelDecay[lane] = noiseDecay[v];
+            gl[lane] = gainLeft[v];
+            gr[lane] = gainRight[v];
+            state[lane] = noiseState[v];
+        }
+
+        for (int frame = 0; frame < numFrames; frame++) {
+            for (int lane = 0; lane < VOICE_LANES; lane++) {
+                // Damped rotation of the resonance phasor
+                float nextRe = (re[lane] * c[lane] - im[lane] * s[lane]) *
+                               decay[lane];
+                float nextIm = (re[lane] * s[lane] + im[lane] * c[lane]) *
+                               decay[lane];
+                re[lane] = nextRe;
+                im[lane] = nextIm;
+
+                // Per-voice LCG white noise in [-1, 1)
+                state[lane] = state[lane] * 1664525u + 1013904223u;
+                float white = (float)(int32_t)state[lane] * 4.656613e-10f;
+                float sample = nextIm + white * level[lane];
+                level[lane] *= levelDecay[lane];
+
+                laneLeft[frame][lane] += sample * gl[lane];
+                laneRight[frame][lane] += sample * gr[lane];
+            }
+        }
+
+        for (int lane = 0; lane < VOICE_LANES; lane++) {
+            int v = group + lane;
+            toneRe[v] = re[lane];
+            toneIm[v] = im[lane];
+            noiseLevel[v] = level[lane];
+            noiseState[v] = state[lane];
+        }
+    }
+
+    for (int frame = 0; frame < numFrames; frame++) {
+        float sumLeft = 0, sumRight = 0;
+        for (int lane = 0; lane < VOICE_LANES; lane++) {
+            sumLeft += laneLeft[frame][lane];
+            sumRight += laneRight[frame][lane];
+        }
+        left[frame] = sumLeft;
+        right[frame] = sumRight;
+    }
+}
+
+void FryingSound::retireSilentVoices() {
+    for (int v = numVoices - 1; v >= 0; v--) {
+        float energy = toneRe[v] * toneRe[v] + toneIm[v] * toneIm[v];
+        if (energy > SILENCE * SILENCE || noiseLevel[v] > SILENCE) continue;
+
+        // Move the last live voice into the hole, keeping voices packed
+        int last = numVoices - 1;
+        toneRe[v] = toneRe[last];
+        toneIm[v] = toneIm[last];
+        toneCos[v] = toneCos[last];
+        toneSin[v] = toneSin[last];
+        toneDecay[v] = toneDecay[last];
+        noiseLevel[v] = noiseLevel[last];
+        noiseDecay[v] = noiseDecay[last];
+        gainLeft[v] = gainLeft[last];
+        gainRight[v] = gainRight[last];
+        clearVoice(last);
+        numVoices--;
+    }
+}
+
+void FryingSound::render(float* output, int numFrames, int numChannels) {
+    BubbleSoundEvent event;
+    while (events.pop(event)) {
+        startVoice(event);
+    }
+
+    float gain = masterGain.load(std::memory_order_relaxed);
+    for (int start = 0; start < numFrames; start += MAX_BLOCK) {
+        int frames = std::min(MAX_BLOCK, numFrames - start);
+        mix(mixLeft, mixRight, frames);
+        retireSilentVoices();
+
+        float* out = output + start * numChannels;
+        for (int i = 0; i < frames; i++) {
+            // Soft clip so dense bursts of explosions saturate gracefully
+            float l = tanh(mixLeft[i] * gain);
+            float r = tanh(mixRight[i] * gain);
+            if (numChannels == 1) {
+                out[i] = 0.5f * (l + r);
+                continue;
+            }
+            out[i * numChannels] = l;
+            out[i * numChannels + 1] = r;
+            for (int c = 2; c < numChannels; c++) {
+                out[i * numChannels + c] = 0;
+            }
+        }
+    }
+
+    activeVoices.store(numVoices, std::memory_order_relaxed);
+}
+
+float FryingSound::getSampleRate() const { return sampleRate; }
+
+int FryingSound::getActiveVoices() const {
+    return activeVoices.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Bubble.h"
+#include "SpscQueue.h"
+
+/**
+ * A bubble reaching the oil surface, as heard by the audio synthesis.
+ * time is simulation time (s); the live path plays events on arrival and
+ * offline rendering places them sample-accurately.
+ */
+struct BubbleSoundEvent {
+    float time;
+    int bubbleType;  // Bubble::bubbleType (0 explosion, 1 elongated, 2 osc.)
+    float size;      // Bubble::size at the surface (px)
+    float pan;       // -1 left .. 1 right
+};
+
+/**
+ * Sound event for a bubble that has just reached the surface, panned by its
+ * position across the oil.
+ */
+BubbleSoundEvent makeBubbleSoundEvent(const Bubble& bubble, float time,
+                                      float oilLeft, float oilRight);
+
+/**
+ * Procedural frying sound built from individual bubble events [5]. Each
+ * event starts a voice: a damped sinusoid at the Minnaert resonance of the
+ * bubble plus a short noise burst for the rupture. Explosion bubbles are
+ * loud and broadband, elongated ones short and bright, oscillating ones ring
+ * longest; thousands of overlapping voices give the familiar sizzle.
+ *
+ * The simulation thread posts events into a lock-free SPSC queue and the
+ * audio thread drains it in render, so neither side ever blocks. Voices are
+ * stored as structure-of-arrays in groups of VOICE_LANES and mixed lane by
+ * lane, which the compiler turns into SIMD without intrinsics.
+ *
+ * Reference:
+ *   [5] Kiyama, A., et al. (2022). "Morphology of bubble dynamics and sound
+ *       in heated oil." Physics of Fluids, 34(6).
+ */
+class FryingSound {
+   public:
+    static const int MAX_VOICES = 512;
+    static const int VOICE_LANES = 8;
+    static const int MAX_BLOCK = 256;
+
+    explicit FryingSound(float sampleRate);
+
+    // Simulation thread. Returns false (and counts a drop) if the queue is
+    // full because the audio thread has stalled.
+    bool post(const BubbleSoundEvent& event);
+
+    // Audio thread. Writes interleaved samples for 1 or more channels.
+    void render(float* output, int numFrames, int numChannels);
+
+    // Starts a voice immediately; used by render and by offline rendering
+    void startVoice(const BubbleSoundEvent& event);
+
+    float getSampleRate() const;
+    int getActiveVoices() const;
+
+    std::atomic<float> masterGain;
+    std::atomic<int> droppedEvents;
+
+   private:
+    void mix(float* left, float* right, int numFrames);
+    void retireSilentVoices();
+    void clearVoice(int voice);
+
+    SpscQueue<BubbleSoundEvent, 4096> events;
+    float sampleRate;
+
+    // Voice state; slots from numVoices up to the next lane multiple are kept
+    // silent so the mix loop can always run whole lane groups
+    alignas(32) float toneRe[MAX_VOICES];
+    alignas(32) float toneIm[MAX_VOICES];
+    alignas(32) float toneCos[MAX_VOICES];
+    alignas(32) float toneSin[MAX_VOICES];
+    alignas(32) float toneDecay[MAX_VOICES];
+    alignas(32) float noiseLevel[MAX_VOICES];
+    alignas(32) float noiseDecay[MAX_VOICES];
+    alignas(32) float gainLeft[MAX_VOICES];
+    alignas(32) float gainRight[MAX_VOICES];
+    alignas(32) uint32_t noiseState[MAX_VOICES];
+    int numVoices;
+    std::atomic<int> activeVoices;
+
+    // Per-lane partial sums, reduced to one sample per frame after mixing
+    alignas(32) float laneLeft[MAX_BLOCK][VOICE_LANES];
+    alignas(32) float laneRight[MAX_BLOCK][VOICE_LANES];
+    float mixLeft[MAX_BLOCK];
+    float mixRight[MAX_BLOCK];
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * A user input captured by an openFrameworks callback. Callbacks only
+ * enqueue these; the simulation applies them between steps, so input never
+ * changes simulation state mid-step and the applied stream, stamped with
+ * the fixed fry step it was applied before, is a complete record that can
+ * be replayed step for step (see ofApp's --record-input/--replay-input).
+ */
+struct InputEvent {
+    // SET_POINT is not a callback but the model-predictive controller's
+    // plan, applied at a wall-clock-dependent step and so recorded too
+    enum Type {
+        KEY_PRESS,
+        MOUSE_MOVE,
+        MOUSE_PRESS,
+        MOUSE_DRAG,
+        MOUSE_RELEASE,
+        SET_POINT
+    };
+
+    Type type;
+    int key;            // KEY_PRESS only
+    float x;            // Mouse events only; °C for SET_POINT
+    float y;
+    float captureTime;  // Wall clock (s) when the callback fired
+    int step;           // Fry steps taken when applied; -1 until then
+};
@@ -0,0 +1,408 @@
+#include "JobServer.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "ofMain.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: SO_NOSIGPIPE is set per socket instead
+#endif
+
+namespace {
+
+const size_t MAX_LINE = 4096;
+const size_t MAX_OUTPUT = 1 << 20;  // Unsent bytes before a client is dropped
+
+// Flat JSON object with string, number or literal values, all kept as text
+bool parseRequest(const std::string& line, SimulationJob::Request& fields) {
+    size_t i = 0;
+    auto skipSpace = [&] {
+        while (i < line.size() && std::isspace((unsigned char)line[i])) i++;
+    };
+    auto parseString = [&](std::string& out) {
+        if (i >= line.size() || line[i] != '"') return false;
+        for (i++; i < line.size() && line[i] != '"'; i++) {
+            if (line[i] == '\\' && i + 1 < line.size()) i++;
+            out.push_back(line[i]);
+        }
+        if (i >= line.size()) return false;
+        i++;
+        return true;
+    };
+
+    skipSpace();
+    if (i >= line.size() || line[i++] != '{') return false;
+    skipSpace();
+    if (i < line.size() && line[i] == '}') return true;
+
+    while (i < line.size()) {
+        std::string key, value;
+        skipSpace();
+        if (!parseString(key)) return false;
+        skipSpace();
+        if (i >= line.size() || line[i++] != ':') return false;
+        skipSpace();
+        if (i < line.size() && line[i] == '"') {
+            if (!parseString(value)) return false;
+        } else {
+            while (i < line.size() && line[i] != ',' && line[i] != '}' &&
+                   !std::isspace((unsigned char)line[i])) {
+                value.push_back(line[i++]);
+            }
+            if (value.empty()) return false;
+        }
+        fields[key] = value;
+
+        skipSpace();
+        if (i < line.size() && line[i] == ',') {
+            i++;
+        } else {
+            return i < line.size() && line[i] == '}';
+        }
+    }
+    return false;
+}
+
+std::string formatEvent(const char* event, int job) {
+    return std::string("{\"event\":\"") + event +
+           "\",\"job\":" + std::to_string(job) + "}";
+}
+
+// job < 0 for errors not tied to a job
+std::string formatError(const std::string& message, int job = -1) {
+    std::string escaped;
+    for (char c : message) {
+        if (c == '"' || c == '\\') escaped.push_back('\\');
+        escaped.push_back(c);
+    }
+    std::string jobField =
+        job >= 0 ? "\"job\":" + std::to_string(job) + "," : "";
+    return "{\"event\":\"error\"," + jobField + "\"message\":\"" +
+           escaped + "\"}";
+}
+
+float getMillis(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+}  // namespace
+
+JobServer::JobServer(const std::string& socketPath, int numThreads)
+    : sliceTarget(0.05f),
+      progressPeriod(0.25f),
+      socketPath(socketPath),
+      listenFd(-1),
+      pool(numThreads),
+      nextJobId(1) {}
+
+JobServer::~JobServer() {
+    for (auto& connection : connections) {
+        if (connection.fd >= 0) ::close(connection.fd);
+    }
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        unlink(socketPath.c_str());
+    }
+}
+
+std::string JobServer::getDefaultPath() { return "/tmp/deepfry-jobs.sock"; }
+
+bool JobServer::start() {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return false;
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+
+    // A socket file left by a previous server would block the bind
+    unlink(socketPath.c_str());
+    if (bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listenFd, 16) != 0) {
+        ofLogError("JobServer") << "cannot listen on " << socketPath;
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+    ofLogNotice("JobServer") << "listening on " << socketPath << " with "
+                             << pool.getNumThreads() << " threads";
+    return true;
+}
+
+void JobServer::run(const std::function<bool()>& stopRequested) {
+    while (!stopRequested()) {
+        // Idle: block on the sockets; busy: just drain them between slices
+        pollConnections(jobs.empty() ? 200 : 0);
+        if (!jobs.empty()) runNextSlice();
+    }
+}
+
+void JobServer::pollConnections(int timeoutMs) {
+    // Clients that stopped reading their events are dropped first
+    for (auto& connection : connections) {
+        if (connection.overflowed) closeConnection(connection);
+    }
+    connections.erase(
+        std::remove_if(connections.begin(), connections.end(),
+                       [](const Connection& c) { return c.fd < 0; }),
+        connections.end());
+
+    std::vector<pollfd> fds;
+    fds.push_back({listenFd, POLLIN, 0});
+    for (const auto& connection : connections) {
+        short events = POLLIN;
+        if (!connection.output.empty()) events |= POLLOUT;
+        fds.push_back({connection.fd, events, 0});
+    }
+    if (::poll(fds.data(), fds.size(), timeoutMs) <= 0) return;
+
+    // Connections accepted below are polled from the next call on
+    size_t numPolled = connections.size();
+    for (size_t c = 0; c < numPolled; c++) {
+        Connection& connection = connections[c];
+        short revents = fds[c + 1].revents;
+
+        if (revents & (POLLIN | POLLHUP | POLLERR)) {
+            char buffer[4096];
+            ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                closeConnection(connection);
+                continue;
+            }
+            connection.input.append(buffer, received);
+
+            size_t end;
+            while (connection.fd >= 0 &&
+                   (end = connection.input.find('\n')) != std::string::npos) {
+                std::string line = connection.input.substr(0, end);
+                connection.input.erase(0, end + 1);
+                handleLine(connection, line);
+            }
+            if (connection.input.size() > MAX_LINE) closeConnection(connection);
+        }
+
+        if (connection.fd >= 0 && !connection.output.empty()) {
+            ssize_t sent = ::send(connection.fd, connection.output.data(),
+                                  connection.output.size(), MSG_NOSIGNAL);
+            if (sent > 0) {
+                connection.output.erase(0, sent);
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                closeConnection(connection);
+            }
+        }
+    }
+    connections.erase(
+        std::remove_if(connections.begin(), connections.end(),
+                       [](const Connection& c) { return c.fd < 0; }),
+        connections.end());
+
+    if (fds[0].revents & POLLIN) {
+        int fd;
+        while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+            int noSigPipe = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe,
+                       sizeof(noSigPipe));
+#endif
+            connections.push_back({fd, "", "", false});
+        }
+    }
+}
+
+void JobServer::handleLine(Connection& connection, const std::string& line) {
+    SimulationJob::Request request;
+    if (!parseRequest(line, request)) {
+        send(connection.fd, formatError("malformed request"));
+        return;
+    }
+
+    std::string op = request["op"];
+    if (op == "submit") {
+        std::string error;
+        std::unique_ptr<SimulationJob> work =
+            SimulationJob::create(request, error);
+        if (!work) {
+            send(connection.fd, formatError(error));
+            return;
+        }
+
+        Job job;
+        job.id = nextJobId++;
+        job.priority = std::atoi(request["priority"].c_str());
+        job.owner = connection.fd;
+        job.work = std::move(work);
+        job.submitted = std::chrono::steady_clock::now();
+        job.lastReport = job.submitted;
+        job.started = false;
+        send(connection.fd, formatEvent("accepted", job.id));
+        jobs.push_back(std::move(job));
+    } else if (op == "cancel") {
+        int id = std::atoi(request["job"].c_str());
+        auto it = std::find_if(jobs.begin(), jobs.end(),
+                               [id](const Job& job) { return job.id == id; });
+        if (it == jobs.end()) {
+            send(connection.fd, formatError("no such job"));
+            return;
+        }
+        if (it->owner != connection.fd) {
+            send(connection.fd, formatEvent("cancelled", id));
+        }
+        cancelJob(id, "cancelled");
+    } else if (op == "status") {
+        std::string reply = "{\"event\":\"status\",\"jobs\":[";
+        for (size_t i = 0; i < jobs.size(); i++) {
+            char entry[160];
+            snprintf(entry, sizeof(entry),
+                     "%s{\"job\":%d,\"type\":\"%s\",\"priority\":%d,"
+                     "\"state\":\"%s\",\"progress\":%.3f}",
+                     i > 0 ? "," : "", jobs[i].id,
+                     jobs[i].work->type.c_str(), jobs[i].priority,
+                     jobs[i].started ? "running" : "queued",
+                     jobs[i].work->getProgress());
+            reply += entry;
+        }
+        send(connection.fd, reply + "]}");
+    } else {
+        send(connection.fd, formatError("unknown op '" + op + "'"));
+    }
+}
+
+void JobServer::runNextSlice() {
+    // Highest priority first, then oldest (lowest id)
+    auto next = std::min_element(
+        jobs.begin(), jobs.end(), [](const Job& a, const Job& b) {
+            if (a.priority != b.priority) return a.priority > b.priority;
+            return a.id < b.id;
+        });
+    Job& job = *next;
+    job.started = true;
+
+    if (job.work->runSlice(pool, sliceTarget)) {
+        if (!job.work->error.empty()) {
+            send(job.owner, formatError(job.work->error, job.id));
+            jobs.erase(next);
+            return;
+        }
+        char header[96];
+        snprintf(header, sizeof(header),
+                 "{\"event\":\"done\",\"job\":%d,\"elapsedMs\":%.1f,", job.id,
+                 getMillis(job.submitted));
+        send(job.owner,
+             header + std::string("\"result\":") + job.work->getResult() + "}");
+        jobs.erase(next);
+        return;
+    }
+
+    if (getMillis(job.lastReport) >= progressPeriod * 1000.0f) {
+        char event[96];
+        snprintf(event, sizeof(event),
+                 "{\"event\":\"progress\",\"job\":%d,\"progress\":%.3f}",
+                 job.id, job.work->getProgress());
+        send(job.owner, event);
+        job.lastReport = std::chrono::steady_clock::now();
+    }
+}
+
+void JobServer::cancelJob(int id, const std::string& reason) {
+    auto it = std::find_if(jobs.begin(), jobs.end(),
+                           [id](const Job& job) { return job.id == id; });
+    if (it == jobs.end()) return;
+    send(it->owner, formatEvent(reason.c_str(), id));
+    jobs.erase(it);
+}
+
+void JobServer::send(int fd, const std::string& line) {
+    for (auto& connection : connections) {
+        if (connection.fd != fd || connection.overflowed) continue;
+        connection.output += line + "\n";
+
+        // Try right away; pollConnections finishes anything left over. A
+        // client that stops reading is dropped there rather than here,
+        // since callers may still hold on to its jobs.
+        ssize_t sent = ::send(fd, connection.output.data(),
+                              connection.output.size(), MSG_NOSIGNAL);
+        if (sent > 0) connection.output.erase(0, sent);
+        if (connection.output.size() > MAX_OUTPUT) {
+            connection.output.clear();
+            connection.overflowed = true;
+        }
+        return;
+    }
+}
+
+void JobServer::closeConnection(Connection& connection) {
+    // Nobody is left to receive these jobs' results
+    int fd = connection.fd;
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+                              [fd](const Job& job) { return job.owner == fd; }),
+               jobs.end());
+    ::close(fd);
+    connection.fd = -1;
+}
+
+bool runJobClient(const std::string& socketPath, const std::string& request) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return false;
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    std::string line = request + "\n";
+    if (::send(fd, line.data(), line.size(), MSG_NOSIGNAL) !=
+        (ssize_t)line.size()) {
+        ::close(fd);
+        return false;
+    }
+
+    // A submission streams until its job ends; anything else gets one reply
+    SimulationJob::Request fields;
+    parseRequest(request, fields);
+    bool streaming = fields["op"] == "submit";
+
+    std::string input;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        input.append(buffer, received);
+        size_t end;
+        while ((end = input.find('\n')) != std::string::npos) {
+            std::string event = input.substr(0, end);
+            input.erase(0, end + 1);
+            printf("%s\n", event.c_str());
+            fflush(stdout);
+
+            SimulationJob::Request reply;
+            parseRequest(event, reply);
+            std::string type = reply["event"];
+            if (!streaming || type == "done" || type == "cancelled" ||
+                type == "error") {
+                ::close(fd);
+                return true;
+            }
+        }
+    }
+    ::close(fd);
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SimulationJob.h"
+#include "WorkerPool.h"
+
+/**
+ * Long-running local service for simulation jobs on a Unix socket. Clients
+ * send one JSON object per line and receive one JSON event per line:
+ *
+ *   {"op":"submit","type":"sweep","priority":0,"resolution":60}
+ *       -> {"event":"accepted","job":3}
+ *          {"event":"progress","job":3,"progress":0.25} ...
+ *          {"event":"done","job":3,"elapsedMs":...,"result":{...}}
+ *   {"op":"cancel","job":3}  -> {"event":"cancelled","job":3}
+ *   {"op":"status"}          -> {"event":"status","jobs":[...]}
+ *
+ * Jobs share one WorkerPool and run one slice at a time: after every slice
+ * the server answers requests and picks the highest-priority job (oldest
+ * first among equals). A long job is therefore preempted at its next
+ * checkpoint when something more urgent arrives, and a short interactive
+ * query waits at most one slice (sliceTarget) behind a big sweep.
+ * Cancellation takes effect between slices. Jobs belong to the connection
+ * that submitted them and are cancelled if it disconnects.
+ */
+class JobServer {
+   public:
+    explicit JobServer(const std::string& socketPath, int numThreads = 0);
+    ~JobServer();
+
+    static std::string getDefaultPath();
+
+    bool start();
+
+    // Serves until stopRequested returns true (checked between slices)
+    void run(const std::function<bool()>& stopRequested);
+
+    float sliceTarget;     // s of work per slice
+    float progressPeriod;  // s between progress events per job
+
+   private:
+    struct Connection {
+        int fd;
+        std::string input;
+        std::string output;
+        bool overflowed;  // Output passed MAX_OUTPUT; closed at next poll
+    };
+
+    struct Job {
+        int id;
+        int priority;
+        int owner;  // Connection fd
+        std::unique_ptr<SimulationJob> work;
+        std::chrono::steady_clock::time_point submitted;
+        std::chrono::steady_clock::time_point lastReport;
+        bool started;
+    };
+
+    void pollConnections(int timeoutMs);
+    void handleLine(Connection& connection, const std::string& line);
+    void runNextSlice();
+    void cancelJob(int id, const std::string& reason);
+    void send(int fd, const std::string& line);
+    void closeConnection(Connection& connection);
+
+    std::string socketPath;
+    int listenFd;
+    WorkerPool pool;
+    std::vector<Connection> connections;
+    std::vector<Job> jobs;
+    int nextJobId;
+};
+
+/**
+ * Sends one request line to a JobServer and prints every event for the
+ * submitted job (or the single reply to other requests) until it ends.
+ * Returns false if the server can't be reached.
+ */
+bool runJobClient(const std::string& socketPath, const std::string& request);
@@ -0,0 +1,288 @@
+#include "KitchenSim.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Rollout.h"
+
+KitchenSim::KitchenSim(unsigned int seed) : seed(seed), rng(seed) {
+    // 12-hour service with lunch and dinner peaks
+    hourlyOrderRate = {20, 45, 90, 80, 35, 25, 30, 60, 95, 85, 45, 20};
+    minPortionsPerOrder = 1;
+    maxPortionsPerOrder = 3;
+
+    // Single-well commercial fryer: ~15 kg oil at cp ≈ 2 kJ/kg·K, 14 kW
+    basketCapacity = 4;
+    portionMass = 0.15f;
+    setPoint = 175.0f;
+    readyTolerance = 5.0f;
+    heaterPower = 14000.0f;
+    oilHeatCapacity = 30000.0f;
+    basketHandlingTime = 15.0f;
+
+    basketsCooked = 0;
+    busyTime = 0.0f;
+    minOilTemperature = setPoint;
+}
+
+void KitchenSim::buildResponseTable(WorkerPool& pool) {
+    const float minTemperature = 160.0f;
+    const float maxTemperature = 190.0f;
+    const float step = 2.0f;
+    int count = (int)((maxTemperature - minTemperature) / step) + 1;
+
+    Potato fry = makeDroppedFry(HEADLESS_OIL_SURFACE_Y, 1);
+    float initialMoisture = fry.moistureContent;
+
+    // Core temperature at which cookedness reaches DONE
+    float doneCoreTemperature =
+        100.0f + 70.0f * sqrt(Potato::DONE_COOKEDNESS);
+    const float potatoSpecificHeat = 3500.0f;  // J/kg·K
+    const float latentHeat = 2.257e6f;         // J/kg
+
+    responseTable.assign(count, FryerResponse());
+    pool.parallelFor(count, [&](int i) {
+        float temperature = minTemperature + i * step;
+        TemperatureSchedule schedule;
+        schedule.switchTimes = {0.0f};
+        schedule.targets = {temperature};
+
+        RolloutResult result =
+            rolloutFry(fry, Oil(HEADLESS_OIL_SURFACE_Y, temperature),
+                       schedule, HEADLESS_BASKET_BOTTOM_Y, 600.0f, 0.25f);
+
+        FryerResponse& response = responseTable[i];
+        response.oilTemperature = temperature;
+        response.cookTime = result.doneTime > 0 ? result.doneTime : 600.0f;
+        response.energyPerKg =
+            potatoSpecificHeat * (doneCoreTemperature - 20.0f) +
+            (initialMoisture - result.moistureAtDone) * latentHeat;
+    });
+}
+
+FryerResponse KitchenSim::lookupResponse(float oilTemperature) const {
+    // Linear interpolation; the rollout oil model is limited to 160-190 °C,
+    // so deeper sags are clamped to the coolest entry
+    const FryerResponse& first = responseTable.front();
+    const FryerResponse& last = responseTable.back();
+    if (oilTemperature <= first.oilTemperature) return first;
+    if (oilTemperature >= last.oilTemperature) return last;
+
+    float spacing = responseTable[1].oilTemperature - first.oilTemperature;
+    float position = (oilTemperature - first.oilTemperature) / spacing;
+    int i = std::min((int)position, (int)responseTable.size() - 2);
+    float f = position - i;
+
+    const FryerResponse& a = responseTable[i];
+    const FryerResponse& b = responseTable[i + 1];
+    FryerResponse response;
+    response.oilTemperature = oilTemperature;
+    response.cookTime = ofLerp(a.cookTime, b.cookTime, f);
+    response.energyPerKg = ofLerp(a.energyPerKg, b.energyPerKg, f);
+    return response;
+}
+
+float KitchenSim::getOilTemperature(const Fryer& fryer, float t) const {
+    // Heater adds P·s/C; a cooking basket removes E(1 - e^(-s/τ))/C
+    float s = t - fryer.lastTime;
+    float temperature = fryer.oilTemperature + heaterPower * s / oilHeatCapacity;
+    if (fryer.cooking) {
+        temperature -= fryer.loadEnergy / oilHeatCapacity *
+                       (1.0f - exp(-s / fryer.loadTimeConstant));
+    }
+    return std::min(setPoint, temperature);
+}
+
+float KitchenSim::getMeanOilTemperature(const Fryer& fryer,
+                                        float duration) const {
+    // Time average of getOilTemperature over [lastTime, lastTime + duration]
+    // (ignores the set point cap, which only matters once recovered)
+    float tau = fryer.loadTimeConstant;
+    float heating = heaterPower * duration / (2.0f * oilHeatCapacity);
+    float loading = fryer.loadEnergy / oilHeatCapacity *
+                    (1.0f - tau / duration * (1.0f - exp(-duration / tau)));
+    return std::min(setPoint, fryer.oilTemperature + heating - loading);
+}
+
+float KitchenSim::getMinOilTemperature(const Fryer& fryer,
+                                       float duration) const {
+    // Sag bottoms out where heater power equals the decaying basket draw
+    float lowest = std::min(fryer.oilTemperature,
+                            getOilTemperature(fryer, fryer.lastTime + duration));
+    float peakDraw = fryer.loadEnergy / fryer.loadTimeConstant;
+    if (peakDraw > heaterPower) {
+        float s = fryer.loadTimeConstant * log(peakDraw / heaterPower);
+        if (s < duration) {
+            lowest = std::min(lowest,
+                              getOilTemperature(fryer, fryer.lastTime + s));
+        }
+    }
+    return lowest;
+}
+
+float KitchenSim::getRecoveryTime(const Fryer& fryer, float t) const {
+    // Called once the basket is out, so recovery is at full heater power
+    float readyTemperature = setPoint - readyTolerance;
+    float temperature = getOilTemperature(fryer, t);
+    if (temperature >= readyTemperature) return t;
+    return t + (readyTemperature - temperature) /
+                   (heaterPower / oilHeatCapacity);
+}
+
+float KitchenSim::nextArrivalTime(float t) {
+    // Thinning of a non-homogeneous Poisson process
+    float maxRate = *std::max_element(hourlyOrderRate.begin(),
+                                      hourlyOrderRate.end());
+    float serviceEnd = hourlyOrderRate.size() * 3600.0f;
+    if (maxRate <= 0.0f) return serviceEnd;
+
+    std::exponential_distribution<float> gap(maxRate / 3600.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    while (true) {
+        t += gap(rng);
+        if (t >= serviceEnd) return serviceEnd;
+        float rate = hourlyOrderRate[(int)(t / 3600.0f)];
+        if (unit(rng) * maxRate < rate) return t;
+    }
+}
+
+void KitchenSim::tryDrop(std::vector<Fryer>& fryers, float t) {
+    for (size_t f = 0; f < fryers.size() && !portionQueue.empty(); f++) {
+        Fryer& fryer = fryers[f];
+        if (fryer.cooking || t < fryer.readyTime) continue;
+
+        float dropTemperature = getOilTemperature(fryer, t);
+        if (dropTemperature < setPoint - readyTolerance - 1e-3f) continue;
+
+        fryer.basketOrders.clear();
+        while (!portionQueue.empty() &&
+               (int)fryer.basketOrders.size() < basketCapacity) {
+            fryer.basketOrders.push_back(portionQueue.front());
+            portionQueue.pop_front();
+        }
+        float basketMass = fryer.basketOrders.size() * portionMass;
+
+        // Cook time depends on the sag it causes: iterate on the mean oil
+        // temperature over the cook. Most of the heat is drawn early
+        // (sensible heating and vigorous boiling), modelled as a load
+        // decaying with a quarter of the cook time.
+        fryer.cooking = true;
+        fryer.oilTemperature = dropTemperature;
+        fryer.lastTime = t;
+
+        float meanTemperature = dropTemperature;
+        float cookTime = 0.0f;
+        for (int iteration = 0; iteration < 3; iteration++) {
+            FryerResponse response = lookupResponse(meanTemperature);
+            cookTime = response.cookTime;
+            fryer.loadEnergy = basketMass * response.energyPerKg;
+            fryer.loadTimeConstant = 0.25f * cookTime;
+            meanTemperature = getMeanOilTemperature(fryer, cookTime);
+        }
+        minOilTemperature = std::min(minOilTemperature,
+                                     getMinOilTemperature(fryer, cookTime));
+
+        busyTime += cookTime;
+        basketsCooked++;
+        events.push({t + cookTime, BASKET_DONE, (int)f});
+    }
+}
+
+KitchenReport KitchenSim::run(int numFryers) {
+    rng.seed(seed);
+    events = decltype(events)();
+    portionQueue.clear();
+    orders.clear();
+    waits.clear();
+    basketsCooked = 0;
+    busyTime = 0.0f;
+    minOilTemperature = setPoint;
+
+    std::vector<Fryer> fryers(numFryers);
+    for (auto& fryer : fryers) {
+        fryer.cooking = false;
+        fryer.oilTemperature = setPoint;
+        fryer.lastTime = 0.0f;
+        fryer.readyTime = 0.0f;
+        fryer.loadEnergy = 0.0f;
+        fryer.loadTimeConstant = 1.0f;
+    }
+
+    KitchenReport report;
+    report.numFryers = numFryers;
+    report.maxQueuedPortions = 0;
+
+    float serviceEnd = hourlyOrderRate.size() * 3600.0f;
+    std::uniform_int_distribution<int> portions(minPortionsPerOrder,
+                                                maxPortionsPerOrder);
+
+    float firstArrival = nextArrivalTime(0.0f);
+    if (firstArrival < serviceEnd) {
+        events.push({firstArrival, ORDER_ARRIVAL, -1});
+    }
+
+    float t = 0.0f;
+    while (!events.empty()) {
+        Event event = events.top();
+        events.pop();
+        t = event.time;
+
+        if (event.type == ORDER_ARRIVAL) {
+            Order order;
+            order.arrivalTime = t;
+            order.portionsRemaining = portions(rng);
+            for (int i = 0; i < order.portionsRemaining; i++) {
+                portionQueue.push_back((int)orders.size());
+            }
+            orders.push_back(order);
+            report.maxQueuedPortions =
+                std::max(report.maxQueuedPortions, (int)portionQueue.size());
+
+            float nextArrival = nextArrivalTime(t);
+            if (nextArrival < serviceEnd) {
+                events.push({nextArrival, ORDER_ARRIVAL, -1});
+            }
+        } else if (event.type == BASKET_DONE) {
+            Fryer& fryer = fryers[event.index];
+            float liftTemperature = getOilTemperature(fryer, t);
+
+            fryer.cooking = false;
+            fryer.oilTemperature = liftTemperature;
+            fryer.lastTime = t;
+
+            for (int orderIndex : fryer.basketOrders) {
+                Order& order = orders[orderIndex];
+                if (--order.portionsRemaining == 0) {
+                    waits.push_back(t - order.arrivalTime);
+                }
+            }
+            fryer.basketOrders.clear();
+
+            fryer.readyTime = std::max(t + basketHandlingTime,
+                                       getRecoveryTime(fryer, t));
+            events.push({fryer.readyTime, FRYER_READY, event.index});
+        }
+
+        tryDrop(fryers, t);
+    }
+
+    report.ordersArrived = (int)orders.size();
+    report.ordersServed = (int)waits.size();
+    report.basketsCooked = basketsCooked;
+    report.minOilTemperature = minOilTemperature;
+    report.utilization =
+        t > 0.0f ? busyTime / (numFryers * std::max(t, serviceEnd)) : 0.0f;
+
+    report.meanWait = 0.0f;
+    report.p95Wait = 0.0f;
+    report.maxWait = 0.0f;
+    if (!waits.empty()) {
+        std::sort(waits.begin(), waits.end());
+        float total = 0.0f;
+        for (float wait : waits) total += wait;
+        report.meanWait = total / waits.size();
+        report.p95Wait = waits[(size_t)(0.95f * (waits.size() - 1))];
+        report.maxWait = waits.back();
+    }
+    return report;
+}
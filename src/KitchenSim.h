@@ -0,0 +1,120 @@
+#pragma once
+
+#include <deque>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "WorkerPool.h"
+
+/**
+ * Cook time and heat load of one basket at a given oil temperature,
+ * tabulated from full-physics rollouts of a single fry. Energy is per kg of
+ * fries: sensible heat up to the DONE core temperature plus latent heat of
+ * the water evaporated by DONE.
+ */
+struct FryerResponse {
+    float oilTemperature;  // °C
+    float cookTime;        // s from drop to DONE
+    float energyPerKg;     // J/kg
+};
+
+/**
+ * Summary of one simulated service period. Waits are from order arrival
+ * until its last portion is lifted.
+ */
+struct KitchenReport {
+    int numFryers;
+    int ordersArrived;
+    int ordersServed;
+    int basketsCooked;
+    float meanWait;  // s
+    float p95Wait;   // s
+    float maxWait;   // s
+    int maxQueuedPortions;
+    float utilization;         // fraction of fryer time spent cooking
+    float minOilTemperature;   // °C, deepest sag under any basket
+};
+
+/**
+ * Discrete-event simulation of order flow through a bank of fryers. Orders
+ * arrive as a non-homogeneous Poisson stream (hourly rate profile), are
+ * queued as portions, and are loaded FIFO into the first fryer that is idle
+ * and whose oil has recovered to within readyTolerance of the set point.
+ *
+ * Fryer physics enters only through a FryerResponse table built once from
+ * rolloutFry: each drop looks up cook time at the mean oil temperature over
+ * the cook and draws the basket's heat load, front-loaded with an
+ * exponentially decaying profile, from a lumped oil heat capacity that the
+ * heater refills at a fixed power. Oil temperature between events is
+ * closed-form, so a full day runs in milliseconds.
+ */
+class KitchenSim {
+   public:
+    explicit KitchenSim(unsigned int seed = 1);
+
+    void buildResponseTable(WorkerPool& pool);
+    KitchenReport run(int numFryers);
+
+    // Demand: orders per hour for each hour of service, starting at open
+    std::vector<float> hourlyOrderRate;
+    int minPortionsPerOrder;
+    int maxPortionsPerOrder;
+
+    // Equipment
+    int basketCapacity;        // portions
+    float portionMass;         // kg
+    float setPoint;            // °C
+    float readyTolerance;      // °C below set point at which drops are allowed
+    float heaterPower;         // W
+    float oilHeatCapacity;     // J/°C
+    float basketHandlingTime;  // s to load, shake out and reset a basket
+
+    // Arrivals are re-seeded per run so fryer counts see the same demand
+    unsigned int seed;
+
+    std::vector<FryerResponse> responseTable;
+
+   private:
+    enum EventType { ORDER_ARRIVAL, BASKET_DONE, FRYER_READY };
+
+    struct Event {
+        float time;
+        EventType type;
+        int index;  // fryer for BASKET_DONE/FRYER_READY
+
+        bool operator>(const Event& other) const { return time > other.time; }
+    };
+
+    struct Fryer {
+        bool cooking;
+        float oilTemperature;  // at lastTime
+        float lastTime;
+        float readyTime;  // earliest next drop (basket handling, recovery)
+        float loadEnergy;        // J drawn by the basket in the oil
+        float loadTimeConstant;  // s, decay of the basket's heat draw
+        std::vector<int> basketOrders;  // order index per portion
+    };
+
+    struct Order {
+        float arrivalTime;
+        int portionsRemaining;
+    };
+
+    FryerResponse lookupResponse(float oilTemperature) const;
+    float getOilTemperature(const Fryer& fryer, float t) const;
+    float getMeanOilTemperature(const Fryer& fryer, float duration) const;
+    float getMinOilTemperature(const Fryer& fryer, float duration) const;
+    float getRecoveryTime(const Fryer& fryer, float t) const;
+    float nextArrivalTime(float t);
+    void tryDrop(std::vector<Fryer>& fryers, float t);
+
+    std::mt19937 rng;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::deque<int> portionQueue;  // order index per waiting portion
+    std::vector<Order> orders;
+    std::vector<float> waits;
+    int basketsCooked;
+    float busyTime;
+    float minOilTemperature;
+};
@@ -0,0 +1,158 @@
+#include "LogValidation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Oil.h"
+#include "Rollout.h"
+
+namespace {
+
+struct LoggedBasket {
+    FryerLogCursor cursor;  // At the drop sample
+    double dropTime;
+    double liftTime;
+    float setPoint;
+};
+
+struct BasketOutcome {
+    float loggedDone;  // s from drop, -1 if not done by the lift
+    float predictedDone;
+    float cookednessError;
+    float moistureError;
+    float minOil;
+};
+
+// The logged and predicted fries share a seed, so they start identical
+BasketOutcome replayBasket(LoggedBasket basket, unsigned int seed, float dt) {
+    float duration = (float)(basket.liftTime - basket.dropTime);
+    float startOil = basket.cursor.getTemperature(basket.dropTime);
+    float setPoint = basket.setPoint > 0.0f ? basket.setPoint : startOil;
+
+    BasketOutcome outcome;
+    outcome.loggedDone = -1.0f;
+    outcome.minOil = startOil;
+
+    // Logged: the oil is the boundary condition, sampled mid-step
+    Potato fry = makeDroppedFry(HEADLESS_OIL_SURFACE_Y, seed);
+    Oil oil(HEADLESS_OIL_SURFACE_Y, startOil);
+    float t = 0.0f;
+    float step = dt;
+    fry.onEvent = [&](const FryEvent& event) {
+        if (event.type != FryEvent::DONE) return;
+        outcome.loggedDone = t + step - (fry.timeInOil - event.time);
+    };
+    while (t < duration) {
+        step = std::min(dt, duration - t);
+        oil.temperature =
+            basket.cursor.getTemperature(basket.dropTime + t + 0.5f * step);
+        outcome.minOil = std::min(outcome.minOil, oil.temperature);
+        fry.update(step, oil.temperature, HEADLESS_OIL_SURFACE_Y,
+                   oil.getDensity(), HEADLESS_BASKET_BOTTOM_Y);
+        t += step;
+    }
+
+    // Predicted at the drop, knowing only the oil then and the set point
+    TemperatureSchedule schedule;
+    schedule.switchTimes = {0.0f};
+    schedule.targets = {setPoint};
+    RolloutResult predicted =
+        rolloutFry(makeDroppedFry(HEADLESS_OIL_SURFACE_Y, seed),
+                   Oil(HEADLESS_OIL_SURFACE_Y, startOil), schedule,
+                   HEADLESS_BASKET_BOTTOM_Y, duration, dt, false);
+    outcome.predictedDone = predicted.doneTime;
+    outcome.cookednessError = predicted.cookednessAtEnd - fry.cookedness;
+    outcome.moistureError = predicted.moistureAtEnd - fry.moistureContent;
+    return outcome;
+}
+
+}  // namespace
+
+LogValidationReport validateFryerLog(const FryerLog& log, WorkerPool& pool,
+                                     float dt) {
+    auto start = std::chrono::steady_clock::now();
+    LogValidationReport report = {};
+
+    // Pass 1: stream the whole log for drops and lifts
+    std::vector<LoggedBasket> baskets;
+    FryerLogCursor cursor(log);
+    bool basketIn = false;
+    double firstTime = 0.0;
+    while (cursor.advance()) {
+        const LogSample& sample = cursor.getCurrent();
+        if (report.numSamples++ == 0) firstTime = sample.time;
+        report.logSeconds = sample.time - firstTime;
+
+        bool fries = sample.fries > 0.0f;
+        if (fries && !basketIn) {
+            baskets.push_back({cursor, sample.time, -1.0, sample.setPoint});
+        } else if (!fries && basketIn) {
+            baskets.back().liftTime = sample.time;
+        }
+        basketIn = fries;
+    }
+    // A basket still in at the end of the log has no outcome to compare
+    if (basketIn) baskets.pop_back();
+
+    // Pass 2: every basket replays from its own cursor
+    std::vector<BasketOutcome> outcomes(baskets.size());
+    pool.parallelFor(baskets.size(), [&](int i) {
+        outcomes[i] = replayBasket(baskets[i], i + 1, dt);
+    });
+
+    report.numBaskets = baskets.size();
+    int numBothDone = 0;
+    for (size_t i = 0; i < baskets.size(); i++) {
+        const BasketOutcome& outcome = outcomes[i];
+        report.basketSeconds += baskets[i].liftTime - baskets[i].dropTime;
+        report.meanCookednessError += outcome.cookednessError;
+        report.meanMoistureError += outcome.moistureError;
+        report.meanMinOil += outcome.minOil;
+        report.loggedDone += outcome.loggedDone >= 0.0f;
+        report.predictedDone += outcome.predictedDone >= 0.0f;
+        if (outcome.loggedDone >= 0.0f && outcome.predictedDone >= 0.0f) {
+            float error = outcome.predictedDone - outcome.loggedDone;
+            report.meanDoneError += error;
+            report.meanAbsDoneError += std::abs(error);
+            report.maxAbsDoneError =
+                std::max(report.maxAbsDoneError, std::abs(error));
+            numBothDone++;
+        }
+    }
+    int n = std::max(1, report.numBaskets);
+    report.meanCookednessError /= n;
+    report.meanMoistureError /= n;
+    report.meanMinOil /= n;
+    report.meanDoneError /= std::max(1, numBothDone);
+    report.meanAbsDoneError /= std::max(1, numBothDone);
+
+    report.wallSeconds = std::chrono::duration<float>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    return report;
+}
+
+std::string formatLogValidation(const LogValidationReport& report) {
+    char text[768];
+    float wall = std::max(report.wallSeconds, 1e-6f);
+    snprintf(text, sizeof(text),
+             "%d samples, %.1f h logged, %d baskets (mean lowest oil "
+             "%.1f C)\n"
+             "DONE before lift: %d logged, %d predicted at drop\n"
+             "DONE time error (predicted - logged): mean %+.1f s, mean abs "
+             "%.1f s, max abs %.1f s\n"
+             "at lift: cookedness error %+.4f, moisture error %+.4f\n"
+             "replayed in %.2f s: %.0fx real time for the log, %.0fx for "
+             "basket time\n",
+             report.numSamples, report.logSeconds / 3600.0f,
+             report.numBaskets, report.meanMinOil, report.loggedDone,
+             report.predictedDone, report.meanDoneError,
+             report.meanAbsDoneError, report.maxAbsDoneError,
+             report.meanCookednessError, report.meanMoistureError,
+             report.wallSeconds, report.logSeconds / wall,
+             report.basketSeconds / wall);
+    return text;
+}
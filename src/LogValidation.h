@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+
+#include "FryerLog.h"
+#include "WorkerPool.h"
+
+/**
+ * Result of checking fry predictions against the baskets in a fryer log.
+ * "Logged" outcomes come from a fry stepped under the log's oil temperature
+ * from drop to lift; "predicted" ones from the rollout made at the drop,
+ * which assumes the oil holds the set point. Errors are predicted minus
+ * logged.
+ */
+struct LogValidationReport {
+    int numSamples;
+    int numBaskets;
+    int loggedDone;             // Baskets done before the lift, logged
+    int predictedDone;          // ... and predicted at the drop
+    float meanDoneError;        // s, over baskets done both ways
+    float meanAbsDoneError;     // s
+    float maxAbsDoneError;      // s
+    float meanCookednessError;  // at the lift
+    float meanMoistureError;    // at the lift
+    float meanMinOil;           // °C, lowest logged oil per basket
+    float logSeconds;           // Logged time covered
+    float basketSeconds;        // Fry time simulated under the log
+    float wallSeconds;
+};
+
+/**
+ * Finds every basket in the log (a drop is the fries column rising from 0,
+ * a lift it returning to 0) and replays them in parallel, each with its own
+ * cursor resuming at the drop, so the log is streamed once to find the
+ * baskets and once more in pieces to replay them.
+ */
+LogValidationReport validateFryerLog(const FryerLog& log, WorkerPool& pool,
+                                     float dt = 0.25f);
+
+std::string formatLogValidation(const LogValidationReport& report);
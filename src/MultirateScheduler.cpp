@@ -0,0 +1,31 @@
+#include "MultirateScheduler.h"
+
+#include <algorithm>
+
+int MultirateScheduler::addRate(float stepSize, int maxStepsPerFrame) {
+    rates.push_back({stepSize, maxStepsPerFrame, 0.0f, 0});
+    return (int)rates.size() - 1;
+}
+
+void MultirateScheduler::advance(float frameTime) {
+    for (auto& rate : rates) {
+        rate.accumulator += frameTime;
+        rate.stepsDue = (int)(rate.accumulator / rate.stepSize);
+        rate.accumulator -= rate.stepsDue * rate.stepSize;
+
+        // Drop the backlog rather than stepping it all in one frame
+        rate.stepsDue = std::min(rate.stepsDue, rate.maxStepsPerFrame);
+    }
+}
+
+int MultirateScheduler::getStepsDue(int rate) const {
+    return rates[rate].stepsDue;
+}
+
+float MultirateScheduler::getStepSize(int rate) const {
+    return rates[rate].stepSize;
+}
+
+float MultirateScheduler::getSubstepFraction(int substep, int numSubsteps) {
+    return (float)(substep + 1) / numSubsteps;
+}
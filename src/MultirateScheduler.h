@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * Fixed-step clocks for subsystems that evolve on different time scales.
+ * Each rate accumulates frame time and reports how many whole steps of its
+ * own size are due, so a subsystem is stepped exactly as often as its
+ * dynamics need regardless of frame rate: slow quantities (oil chemistry)
+ * skip most frames, medium ones (fries) step a few times per frame at most.
+ *
+ * Faster subsystems (bubbles) are sub-cycled inside a medium step by the
+ * caller, with the slower state interpolated across the substeps; see
+ * getSubstepFraction.
+ */
+class MultirateScheduler {
+   public:
+    // Returns the rate's id. Steps beyond maxStepsPerFrame are dropped so a
+    // stalled frame cannot trigger a catch-up spiral.
+    int addRate(float stepSize, int maxStepsPerFrame);
+
+    void advance(float frameTime);
+    int getStepsDue(int rate) const;
+    float getStepSize(int rate) const;
+
+    // Position of substep (0-based) at the end of its interval, in (0, 1]
+    static float getSubstepFraction(int substep, int numSubsteps);
+
+   private:
+    struct Rate {
+        float stepSize;
+        int maxStepsPerFrame;
+        float accumulator;
+        int stepsDue;
+    };
+
+    std::vector<Rate> rates;
+};
@@ -1,13 +1,48 @@
 #include "Oil.h"
 
+#include <cmath>
+
 Oil::Oil(float y, float temp) {
     surfaceY = y;
     temperature = temp;
+    polarCompounds = 4.0f;
     time = 0;
 }
 
 void Oil::update(float deltaTime) { time += deltaTime; }
 
+void Oil::approachTarget(float targetTemperature, float deltaTime) {
+    // First-order heater response, time constant ~0.33 s (equivalent to
+    // 5% of the remaining gap per frame at 60 FPS), independent of step size
+    const float timeConstant = 0.325f;
+    float alpha = 1.0f - exp(-deltaTime / timeConstant);
+    temperature += (targetTemperature - temperature) * alpha;
+    temperature = ofClamp(temperature, 160.0f, 190.0f);
+}
+
+void Oil::degrade(float deltaTime, float waterReleased) {
+    float oxidationRate = 0.15f * pow(2.0f, (temperature - 180.0f) / 10.0f);
+    polarCompounds += oxidationRate * deltaTime / 3600.0f;
+    polarCompounds += 0.02f * waterReleased;
+}
+
+float Oil::getDensity() const {
+    // Linear thermal expansion model [4]
+    // ρ(T) = ρ₀ - α(T - T₀), where ρ₀ = 0.915 g/cm³ at T₀ = 20°C
+    // Result: ~0.825 g/cm³ at 160°C, ~0.806 g/cm³ at 190°C
+    return 0.915f - 0.00064f * (temperature - 20.0f);
+}
+
+float Oil::getViscosity() const {
+    // Arrhenius viscosity model [4]
+    // μ = A * exp(Ea/RT), non-linear temperature dependence
+    float T_Kelvin = temperature + 273.15f;
+    float viscosity_inf = 0.00001f;
+    float Ea_R = 2500.0f;
+    float viscosity = viscosity_inf * exp(Ea_R / T_Kelvin);
+    return ofClamp(viscosity, 0.003f, 0.030f);
+}
+
 ofColor Oil::getTemperatureColor() {
     ofColor coolOil(210, 170, 70, 180);
     ofColor mediumOil(230, 185, 85, 190);
@@ -3,20 +3,37 @@
 #include "ofMain.h"
 
 /**
- * Provides temperature-based color for oil rendering.
- * Primary oil body rendering is handled by ofApp.
+ * Oil state shared by the viewer and headless rollouts: temperature response
+ * to the heater set point, density, viscosity, degradation, and
+ * temperature-based rendering color. Primary oil body rendering is handled
+ * by ofApp.
+ *
+ * Degradation is tracked as total polar compounds (TPC, %), the usual
+ * discard criterion (~25%): thermo-oxidative formation doubling every
+ * 10 °C (0.15 %/h at 180 °C) plus hydrolysis by water released from the
+ * food (0.02 % per kg of water in a 15 kg well).
  *
  * Temperature range: 160-190°C (standard deep frying temperatures)
+ *
+ * Reference:
+ *   [4] Fasina, O.O. & Colley, Z. (2008). "Viscosity and specific heat of
+ *       vegetable oils as a function of temperature." Int. J. Food Properties,
+ *       11(4), 738-746.
  */
 class Oil {
    public:
     Oil(float surfaceY, float initialTemperature);
 
     void update(float deltaTime);
+    void approachTarget(float targetTemperature, float deltaTime);
+    void degrade(float deltaTime, float waterReleased);
+    float getDensity() const;
+    float getViscosity() const;
     ofColor getTemperatureColor();
 
     float surfaceY;
     float temperature;
+    float polarCompounds;  // % TPC, ~4% fresh
 
    private:
     float time;
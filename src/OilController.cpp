@@ -0,0 +1,183 @@
+#include "OilController.h"
+
+#include <algorithm>
+#include <chrono>
+
+OilController::Plan::Plan(const Potato& fry, const Oil& oil)
+    : fry(fry), oil(oil) {}
+
+OilController::OilController(int numThreads)
+    : pool(numThreads),
+      pending(nullptr),
+      finished(nullptr),
+      solving(false),
+      stopping(false),
+      generation(0),
+      solver(&OilController::solverLoop, this) {
+    controlInterval = 0.1f;
+    horizon = 240.0f;
+    rolloutStep = 0.25f;
+    minMoistureAtDone = 0.35f;
+    maxThermalDose = 120.0f;
+
+    numCandidates = 0;
+    reset();
+
+    buildCandidates();
+}
+
+OilController::~OilController() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    solver.join();
+    delete pending;
+    delete finished;
+}
+
+void OilController::reset() {
+    cancel();
+    predictedDoneTime = -1.0f;
+    lastSolveMillis = 0.0f;
+    appliedDose = 0.0f;
+}
+
+void OilController::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    delete pending;
+    delete finished;
+    pending = nullptr;
+    finished = nullptr;
+}
+
+bool OilController::request(const Potato& fry, const Oil& oil,
+                            float currentTarget, float basketBottomY) {
+    // Dose the current fry has received since the previous re-plan
+    appliedDose += std::max(0.0f, oil.temperature - 175.0f) * controlInterval;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (solving || pending != nullptr) return false;
+    pending = new Plan(fry, oil);
+    pending->fry.onEvent = nullptr;
+    pending->currentTarget = currentTarget;
+    pending->basketBottomY = basketBottomY;
+    pending->appliedDose = appliedDose;
+    pending->generation = generation;
+    wake.notify_one();
+    return true;
+}
+
+bool OilController::poll(float& target) {
+    Plan* plan;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        plan = finished;
+        finished = nullptr;
+    }
+    if (plan == nullptr) return false;
+
+    target = plan->target;
+    predictedDoneTime = plan->predictedDoneTime;
+    lastSolveMillis = plan->solveMillis;
+    delete plan;
+    return true;
+}
+
+void OilController::solverLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || pending != nullptr; });
+        if (stopping) return;
+        Plan* plan = pending;
+        pending = nullptr;
+        solving = true;
+
+        lock.unlock();
+        solve(*plan);
+        lock.lock();
+
+        solving = false;
+        if (plan->generation == generation) {
+            delete finished;
+            finished = plan;
+        } else {
+            delete plan;
+        }
+    }
+}
+
+void OilController::buildCandidates() {
+    // Set points in the UP/DOWN range and step, switch times spread over
+    // a typical fry: 7 x 6 x 7 = 294 schedules
+    const float setPoints[] = {160, 165, 170, 175, 180, 185, 190};
+    const float switchTimes[] = {5, 10, 20, 30, 45, 60};
+
+    candidates.clear();
+    for (float first : setPoints) {
+        for (float switchTime : switchTimes) {
+            for (float second : setPoints) {
+                TemperatureSchedule schedule;
+                schedule.switchTimes = {0.0f, switchTime};
+                schedule.targets = {first, second};
+                candidates.push_back(schedule);
+            }
+        }
+    }
+
+    numCandidates = (int)candidates.size();
+    results.resize(candidates.size());
+}
+
+void OilController::solve(Plan& plan) {
+    auto start = std::chrono::steady_clock::now();
+
+    pool.parallelFor(numCandidates, [&](int i) {
+        results[i] = rolloutFry(plan.fry, plan.oil, candidates[i],
+                                plan.basketBottomY, horizon, rolloutStep);
+    });
+
+    // Soonest feasible DONE wins; if nothing is feasible, take the
+    // candidate with the smallest quality violation
+    int best = -1;
+    int leastViolating = -1;
+    float leastViolation = 0.0f;
+    for (int i = 0; i < numCandidates; i++) {
+        const RolloutResult& r = results[i];
+        if (r.doneTime < 0) continue;
+
+        float moistureExcess =
+            std::max(0.0f, minMoistureAtDone - r.moistureAtDone) /
+            minMoistureAtDone;
+        float doseExcess =
+            std::max(0.0f,
+                     plan.appliedDose + r.thermalDose - maxThermalDose) /
+            maxThermalDose;
+        float violation = moistureExcess + doseExcess;
+
+        if (leastViolating < 0 || violation < leastViolation) {
+            leastViolating = i;
+            leastViolation = violation;
+        }
+        if (violation > 0.0f) continue;
+        if (best < 0 || r.doneTime < results[best].doneTime) {
+            best = i;
+        }
+    }
+    if (best < 0) best = leastViolating;
+
+    auto end = std::chrono::steady_clock::now();
+    plan.solveMillis =
+        std::chrono::duration<float, std::milli>(end - start).count();
+
+    if (best < 0) {
+        plan.predictedDoneTime = -1.0f;
+        plan.target = plan.currentTarget;
+        return;
+    }
+
+    plan.predictedDoneTime = results[best].doneTime;
+    plan.target = candidates[best].targets[0];
+}
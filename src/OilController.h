@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Oil.h"
+#include "Potato.h"
+#include "Rollout.h"
+#include "WorkerPool.h"
+
+/**
+ * Model-predictive controller for the oil set point. Every control interval
+ * it fast-forwards the current fry under a grid of candidate two-segment
+ * heater schedules (first set point, switch time, second set point) and
+ * applies the first set point of the schedule that reaches DONE soonest
+ * within the quality limit: moisture at DONE of at least minMoistureAtDone
+ * and a total oil thermal dose above 175 °C (already applied plus
+ * predicted) of at most maxThermalDose.
+ *
+ * Re-plans run off the caller's thread: request() copies the fry and oil
+ * and returns at once, the controller's solver thread fans the rollouts
+ * out over its WorkerPool, and poll() hands back the set point once the
+ * plan is finished, so the simulation step never waits for a solve.
+ */
+class OilController {
+   public:
+    explicit OilController(int numThreads = 0);
+    ~OilController();
+    OilController(const OilController&) = delete;
+    OilController& operator=(const OilController&) = delete;
+
+    // Also discards any plan in flight
+    void reset();
+    void cancel();
+
+    // Counts one control interval of applied dose and starts a re-plan
+    // from this state; false if the previous one is still running
+    bool request(const Potato& fry, const Oil& oil, float currentTarget,
+                 float basketBottomY);
+
+    // True once, with the planned set point, when a requested plan is done
+    bool poll(float& target);
+
+    float controlInterval;    // s between re-plans
+    float horizon;            // s simulated per rollout
+    float rolloutStep;        // s, fixed rollout step
+    float minMoistureAtDone;  // quality limit (fraction)
+    float maxThermalDose;     // quality limit (°C·s above 175 °C)
+
+    // Diagnostics from the most recent plan poll() returned
+    float predictedDoneTime;  // s from now, -1 if no candidate finishes
+    float lastSolveMillis;
+    float appliedDose;
+    int numCandidates;
+
+   private:
+    // One re-plan's inputs and outputs, owned by the solver while solving
+    struct Plan {
+        Plan(const Potato& fry, const Oil& oil);
+
+        Potato fry;
+        Oil oil;
+        float currentTarget;
+        float basketBottomY;
+        float appliedDose;
+        unsigned long generation;  // Stale once reset or cancel bumps it
+
+        float target;
+        float predictedDoneTime;
+        float solveMillis;
+    };
+
+    void buildCandidates();
+    void solverLoop();
+    void solve(Plan& plan);
+
+    WorkerPool pool;
+    std::vector<TemperatureSchedule> candidates;
+    std::vector<RolloutResult> results;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    Plan* pending;   // Requested, not yet picked up by the solver
+    Plan* finished;  // Solved, not yet polled
+    bool solving;
+    bool stopping;
+    unsigned long generation;
+    std::thread solver;  // Last, so it starts after the state above
+};
@@ -0,0 +1,69 @@
+#include "ParticlePool.h"
+
+ParticlePool::ParticlePool(int capacity) {
+    x.resize(capacity);
+    y.resize(capacity);
+    vx.resize(capacity);
+    vy.resize(capacity);
+    size.resize(capacity);
+    age.resize(capacity);
+    lifespan.resize(capacity);
+    count = 0;
+}
+
+bool ParticlePool::spawn(float px, float py, float pvx, float pvy,
+                         float psize, float plifespan) {
+    if (count == getCapacity()) return false;
+    x[count] = px;
+    y[count] = py;
+    vx[count] = pvx;
+    vy[count] = pvy;
+    size[count] = psize;
+    age[count] = 0;
+    lifespan[count] = plifespan;
+    count++;
+    return true;
+}
+
+void ParticlePool::sway(float dt, float swayX, std::mt19937& rng) {
+    std::uniform_real_distribution<float> accel(-swayX, swayX);
+    for (int i = 0; i < count; i++) vx[i] += accel(rng) * dt;
+}
+
+void ParticlePool::integrate(float dt, float ax, float ay, float drag) {
+    float* px = x.data();
+    float* py = y.data();
+    float* pvx = vx.data();
+    float* pvy = vy.data();
+    float* page = age.data();
+
+    for (int i = 0; i < count; i++) {
+        pvx[i] += (ax - drag * pvx[i]) * dt;
+        pvy[i] += (ay - drag * pvy[i]) * dt;
+        px[i] += pvx[i] * dt;
+        py[i] += pvy[i] * dt;
+        page[i] += dt;
+    }
+}
+
+void ParticlePool::expireFallingBelow(float level) {
+    for (int i = 0; i < count; i++) {
+        if (vy[i] > 0 && y[i] > level) age[i] = lifespan[i];
+    }
+}
+
+void ParticlePool::removeExpired() {
+    for (int i = count - 1; i >= 0; i--) {
+        if (age[i] < lifespan[i]) continue;
+        count--;
+        x[i] = x[count];
+        y[i] = y[count];
+        vx[i] = vx[count];
+        vy[i] = vy[count];
+        size[i] = size[count];
+        age[i] = age[count];
+        lifespan[i] = lifespan[count];
+    }
+}
+
+int ParticlePool::getCapacity() const { return (int)x.size(); }
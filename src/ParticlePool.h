@@ -0,0 +1,42 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+/**
+ * Fixed-budget pool of simple point particles stored as structure-of-arrays,
+ * for effects that need many particles but no per-particle behaviour beyond
+ * constant acceleration, linear drag and an optional random horizontal
+ * sway drawn per particle each step (steam, splatter). The budget is
+ * allocated up front; spawning past it fails instead of growing, so an
+ * effect can never cost more than its budget per frame.
+ *
+ * Live particles are packed in [0, count); expired ones are swap-removed.
+ * integrate is a single branch-free pass the compiler vectorizes; sway
+ * draws happen in their own pass before it.
+ */
+class ParticlePool {
+   public:
+    explicit ParticlePool(int capacity);
+
+    bool spawn(float px, float py, float pvx, float pvy, float psize,
+               float plifespan);
+    // Each particle gets its own uniform [-swayX, swayX] px/s² from rng
+    void sway(float dt, float swayX, std::mt19937& rng);
+    void integrate(float dt, float ax, float ay, float drag);
+
+    // Ends falling particles that have dropped back below y
+    void expireFallingBelow(float y);
+    void removeExpired();
+
+    int getCapacity() const;
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> size;
+    std::vector<float> age;
+    std::vector<float> lifespan;
+    int count;
+};
@@ -3,7 +3,7 @@
 #include <algorithm>
 #include <cmath>
 
-Potato::Potato(ofVec2f startPos, ofVec2f sz) {
+Potato::Potato(ofVec2f startPos, ofVec2f sz, unsigned int seed) : rng(seed) {
     position = startPos;
     size = sz;
     velocity = ofVec2f(0, 0);
@@ -19,12 +19,295 @@ Potato::Potato(ofVec2f startPos, ofVec2f sz) {
 
     isInOil = false;
     vigorousBubblingPhase = false;
+    resolved = false;
+    selected = false;
+    firedEvents = 0;
+    bubbleExposure = -log(std::max(1e-7f, 1.0f - random(0.0f, 1.0f)));
+    std::fill(nodeTemperatures, nodeTemperatures + CONDUCTION_NODES,
+              temperature);
+    buildPerimeter();
 
     currentColor = ofColor(230, 215, 170);
 }
 
+float Potato::random(float low, float high) {
+    return std::uniform_real_distribution<float>(low, high)(rng);
+}
+
+void Potato::buildPerimeter() {
+    // Segments evenly spaced by arc length around the outline, clockwise
+    // from the top-left corner
+    float halfW = size.x / 2.0f, halfH = size.y / 2.0f;
+    float perimeter = 2.0f * (size.x + size.y);
+    auto pointAt = [&](float s) {
+        s = fmod(s, perimeter);
+        if (s < size.x) return ofVec2f(-halfW + s, -halfH);
+        s -= size.x;
+        if (s < size.y) return ofVec2f(halfW, -halfH + s);
+        s -= size.y;
+        if (s < size.x) return ofVec2f(halfW - s, halfH);
+        s -= size.x;
+        return ofVec2f(-halfW, halfH - s);
+    };
+
+    float spacing = perimeter / PERIMETER_SEGMENTS;
+    float totalExposure = 0;
+    for (int k = 0; k < PERIMETER_SEGMENTS; k++) {
+        float s0 = k * spacing, s1 = (k + 1) * spacing;
+        segmentStart[k] = pointAt(s0);
+        segmentSpan[k] = pointAt(s1) - segmentStart[k];
+
+        // Heat and vapour escape through two faces at corners and through
+        // the cut end grain, so those dry and crisp first
+        float mid = fmod(s0 + 0.5f * spacing, perimeter);
+        bool onEnd = (mid >= size.x && mid < size.x + size.y) ||
+                     mid >= 2.0f * size.x + size.y;
+        bool atCorner = false;
+        float corners[] = {0, size.x, size.x + size.y, 2 * size.x + size.y,
+                           perimeter};
+        for (float c : corners) {
+            if (s0 <= c && c <= s1) atCorner = true;
+        }
+        segmentExposure[k] = atCorner ? 1.6f : (onEnd ? 1.3f : 1.0f);
+        segmentExposure[k] *= random(0.9f, 1.1f);
+        totalExposure += segmentExposure[k];
+
+        segmentMoisture[k] = moistureContent;
+        segmentCrust[k] = crustThickness;
+
+        // Cavity strength varies several-fold between sites and persists
+        siteActivity[k] = exp(random(-1.0f, 1.0f));
+    }
+
+    // Normalize to mean exposure 1 so segment means track the aggregates
+    for (int k = 0; k < PERIMETER_SEGMENTS; k++) {
+        segmentExposure[k] *= PERIMETER_SEGMENTS / totalExposure;
+    }
+
+    siteTableAge = 0;
+    rebuildSiteTable();
+}
+
+void Potato::updatePerimeter(float evaporation, float crustFormation) {
+    // Same kinetics as the aggregates, per segment; branch-free over the
+    // fixed segment count so the loop vectorizes
+    for (int k = 0; k < PERIMETER_SEGMENTS; k++) {
+        float exposure = segmentExposure[k];
+        float barrier = 1.0f - 0.3f * segmentCrust[k];
+        float moisture = segmentMoisture[k] - evaporation * exposure * barrier;
+        segmentMoisture[k] = std::min(0.79f, std::max(0.01f, moisture));
+        float crust = segmentCrust[k] +
+                      crustFormation * exposure * (1.0f - segmentCrust[k]);
+        segmentCrust[k] = std::min(1.0f, std::max(0.0f, crust));
+    }
+}
+
+void Potato::rebuildSiteTable() {
+    // Wet sites boil (quadratic falloff below 10%, as the aggregate rate);
+    // crust chokes vapour escape
+    float weights[PERIMETER_SEGMENTS];
+    for (int k = 0; k < PERIMETER_SEGMENTS; k++) {
+        float wetness = std::min(1.0f, segmentMoisture[k] / 0.1f);
+        weights[k] = siteActivity[k] * wetness * wetness *
+                     (1.0f - 0.5f * segmentCrust[k]);
+    }
+    buildAliasTable(weights);
+}
+
+void Potato::buildAliasTable(const float* weights) {
+    // Vose's alias method: O(n) build, O(1) draw
+    const int n = PERIMETER_SEGMENTS;
+    float total = 0;
+    for (int k = 0; k < n; k++) total += weights[k];
+
+    float scaled[n];
+    int small[n], large[n];
+    int numSmall = 0, numLarge = 0;
+    for (int k = 0; k < n; k++) {
+        scaled[k] = total > 0 ? weights[k] * n / total : 1.0f;
+        siteShare[k] = scaled[k] / n;
+        if (scaled[k] < 1.0f) {
+            small[numSmall++] = k;
+        } else {
+            large[numLarge++] = k;
+        }
+    }
+
+    while (numSmall > 0 && numLarge > 0) {
+        int s = small[--numSmall];
+        int l = large[--numLarge];
+        aliasProbability[s] = scaled[s];
+        aliasSite[s] = l;
+        scaled[l] += scaled[s] - 1.0f;
+        if (scaled[l] < 1.0f) {
+            small[numSmall++] = l;
+        } else {
+            large[numLarge++] = l;
+        }
+    }
+
+    // Leftovers are 1 up to rounding
+    while (numLarge > 0) {
+        int l = large[--numLarge];
+        aliasProbability[l] = 1.0f;
+        aliasSite[l] = l;
+    }
+    while (numSmall > 0) {
+        int s = small[--numSmall];
+        aliasProbability[s] = 1.0f;
+        aliasSite[s] = s;
+    }
+}
+
 void Potato::update(float dt, float oilTemp, float oilSurfaceY,
                     float oilDensity, float basketBottomY) {
+    const unsigned int allEvents = (1u << FryEvent::FLOAT) |
+                                   (1u << FryEvent::DONE) |
+                                   (1u << FryEvent::BUBBLING_END);
+    if (!onEvent || firedEvents == allEvents) {
+        integrate(dt, oilTemp, oilSurfaceY, oilDensity, basketBottomY);
+        return;
+    }
+
+    // Event detection: sample each indicator before and after the step,
+    // then locate sign changes inside the step by root-finding
+    const FryEvent::Type types[] = {FryEvent::FLOAT, FryEvent::DONE,
+                                    FryEvent::BUBBLING_END};
+    const int numTypes = 3;
+
+    StepState start = saveStep();
+    float before[numTypes];
+    for (int i = 0; i < numTypes; i++) {
+        before[i] = eventIndicator(types[i], oilTemp, oilDensity);
+    }
+
+    integrate(dt, oilTemp, oilSurfaceY, oilDensity, basketBottomY);
+
+    float after[numTypes];
+    for (int i = 0; i < numTypes; i++) {
+        after[i] = eventIndicator(types[i], oilTemp, oilDensity);
+    }
+
+    // Refinement re-steps this fry in place, so keep the end state
+    StepState end = saveStep();
+    FryEvent fired[numTypes];
+    int numFired = 0;
+    for (int i = 0; i < numTypes; i++) {
+        unsigned int bit = 1u << types[i];
+        if (firedEvents & bit) continue;
+
+        if (before[i] > 0.0f && after[i] <= 0.0f) {
+            firedEvents |= bit;
+            float fraction =
+                refineEventTime(start, types[i], before[i], after[i], dt,
+                                oilTemp, oilSurfaceY, oilDensity,
+                                basketBottomY);
+            fired[numFired++] = {types[i],
+                                 end.timeInOil - (1.0f - fraction) * dt};
+        }
+    }
+    if (numFired == 0) return;
+    restoreStep(end);
+
+    std::sort(fired, fired + numFired,
+              [](const FryEvent& a, const FryEvent& b) {
+                  return a.time < b.time;
+              });
+    for (int i = 0; i < numFired; i++) {
+        onEvent(fired[i]);
+    }
+}
+
+Potato::StepState Potato::saveStep() const {
+    StepState state;
+    state.position = position;
+    state.velocity = velocity;
+    state.moistureContent = moistureContent;
+    state.temperature = temperature;
+    state.cookedness = cookedness;
+    state.crustThickness = crustThickness;
+    state.density = density;
+    state.timeInOil = timeInOil;
+    state.isInOil = isInOil;
+    state.vigorousBubblingPhase = vigorousBubblingPhase;
+    std::copy(nodeTemperatures, nodeTemperatures + CONDUCTION_NODES,
+              state.nodeTemperatures);
+    state.currentColor = currentColor;
+    return state;
+}
+
+void Potato::restoreStep(const StepState& state) {
+    position = state.position;
+    velocity = state.velocity;
+    moistureContent = state.moistureContent;
+    temperature = state.temperature;
+    cookedness = state.cookedness;
+    crustThickness = state.crustThickness;
+    density = state.density;
+    timeInOil = state.timeInOil;
+    isInOil = state.isInOil;
+    vigorousBubblingPhase = state.vigorousBubblingPhase;
+    std::copy(state.nodeTemperatures,
+              state.nodeTemperatures + CONDUCTION_NODES, nodeTemperatures);
+    currentColor = state.currentColor;
+}
+
+float Potato::eventIndicator(FryEvent::Type type, float oilTemp,
+                             float oilDensity) {
+    // Positive before the event, non-positive once it has occurred
+    switch (type) {
+        case FryEvent::FLOAT:
+            return density - oilDensity;
+        case FryEvent::DONE:
+            return DONE_COOKEDNESS - cookedness;
+        case FryEvent::BUBBLING_END:
+            if (!isInOil) return 1.0f;
+            return getBubbleGenerationFactor(oilTemp) - BUBBLING_END_FACTOR;
+    }
+    return 1.0f;
+}
+
+float Potato::refineEventTime(const StepState& start, FryEvent::Type type,
+                              float gStart, float gEnd, float dt,
+                              float oilTemp, float oilSurfaceY,
+                              float oilDensity, float basketBottomY) {
+    // Illinois (modified regula falsi) on the step fraction s in [0, 1],
+    // where g(s) is the indicator after integrating s * dt from the start
+    // state. Returns the earliest bracketed fraction at which g <= 0.
+    // Probes re-step only the bulk state the indicators depend on, in
+    // place; the caller restores the end-of-step state afterwards.
+    float lo = 0.0f, hi = 1.0f;
+    float gLo = gStart, gHi = gEnd;
+    int side = 0;
+
+    for (int i = 0; i < 12 && hi - lo > 1e-4f; i++) {
+        float s = lo + (hi - lo) * gLo / (gLo - gHi);
+        s = ofClamp(s, lo + 0.01f * (hi - lo), hi - 0.01f * (hi - lo));
+
+        restoreStep(start);
+        integrate(s * dt, oilTemp, oilSurfaceY, oilDensity, basketBottomY,
+                  false);
+        float g = eventIndicator(type, oilTemp, oilDensity);
+
+        if (g > 0.0f) {
+            lo = s;
+            gLo = g;
+            if (side == 1) gHi *= 0.5f;
+            side = 1;
+        } else {
+            hi = s;
+            gHi = g;
+            if (side == -1) gLo *= 0.5f;
+            side = -1;
+        }
+    }
+
+    return hi;
+}
+
+void Potato::integrate(float dt, float oilTemp, float oilSurfaceY,
+                       float oilDensity, float basketBottomY,
+                       bool updateSurface) {
     if (position.y > oilSurfaceY) {
         if (!isInOil) {
             isInOil = true;
@@ -38,8 +321,8 @@ void Potato::update(float dt, float oilTemp, float oilSurfaceY,
         // Temperature-dependent evaporation following first-order kinetics
         // Vigorous phase (0-20s): higher evaporation rate due to intense
         // boiling Post-vigorous phase (>20s): reduced rate as surface dries
+        float evaporationRateBase = 0.0f;
         if (temperature > 100.0f) {
-            float evaporationRateBase;
             if (timeInOil < 20.0f) {
                 evaporationRateBase =
                     0.02f * dt * (temperature - 100.0f) / 75.0f;
@@ -77,12 +360,27 @@ void Potato::update(float dt, float oilTemp, float oilSurfaceY,
         crustThickness += crustFormationCoeff * dt * (1.0f - crustThickness);
         crustThickness = ofClamp(crustThickness, 0.0f, 1.0f);
 
+        // Local surface state around the outline, and the nucleation
+        // weights that follow it
+        if (updateSurface) {
+            updatePerimeter(evaporationRateBase, crustFormationCoeff * dt);
+            siteTableAge += dt;
+            if (siteTableAge >= SITE_TABLE_INTERVAL) {
+                siteTableAge = 0;
+                rebuildSiteTable();
+            }
+        }
+
         // Heat transfer (Newton's Law of Cooling)
         // dT/dt = h(T_oil - T_potato) where h varies with cooking phase
-        float baseTempDiff = oilTemp - temperature;
         float heatTransferCoeff = getEffectiveHeatTransferCoefficient();
-        float heatTransferRate = heatTransferCoeff * dt;
-        temperature += baseTempDiff * heatTransferRate;
+        if (resolved) {
+            conduct(dt, oilTemp, heatTransferCoeff);
+        } else {
+            float baseTempDiff = oilTemp - temperature;
+            float heatTransferRate = heatTransferCoeff * dt;
+            temperature += baseTempDiff * heatTransferRate;
+        }
         temperature = ofClamp(temperature, 20.0f, oilTemp);
 
         // Cookedness based on Maillard reaction kinetics
@@ -172,7 +470,7 @@ void Potato::draw() {
         ofDrawEllipse(tx, ty, tsize, tsize * 0.7f);
     }
 
-    // Crust rendering
+    // Crust rendering, segment by segment from the local crust
     if (crustThickness > 0.1f) {
         float crustR =
             ofLerp(currentColor.r, currentColor.r - 30, crustThickness);
@@ -181,12 +479,17 @@ void Potato::draw() {
         float crustB =
             ofLerp(currentColor.b, currentColor.b - 55, crustThickness);
 
-        ofNoFill();
-        ofSetLineWidth(1.5f + crustThickness * 2.5f);
-        ofSetColor(crustR, crustG, crustB, 180 + crustThickness * 60);
-        ofDrawRectRounded(-fryHalfWidth, -fryHalfHeight, size.x, size.y,
-                          cornerRadius);
-        ofFill();
+        for (int k = 0; k < PERIMETER_SEGMENTS; k++) {
+            float crust = segmentCrust[k];
+            if (crust <= 0.1f) continue;
+            ofSetLineWidth(1.5f + crust * 2.5f);
+            ofSetColor(ofLerp(currentColor.r, currentColor.r - 30, crust),
+                       ofLerp(currentColor.g, currentColor.g - 45, crust),
+                       ofLerp(currentColor.b, currentColor.b - 55, crust),
+                       180 + crust * 60);
+            ofVec2f end = segmentStart[k] + segmentSpan[k];
+            ofDrawLine(segmentStart[k].x, segmentStart[k].y, end.x, end.y);
+        }
 
         if (crustThickness > 0.4f) {
             int numBumps = (int)(crustThickness * 20);
@@ -300,20 +603,41 @@ ofColor Potato::getCookingColor() {
     }
 }
 
+ofVec2f Potato::sampleSite(float u, int& site) const {
+    // One uniform picks the column, the keep/alias coin, and (rescaled from
+    // the coin's interval) the position along the chosen site
+    float scaled = u * PERIMETER_SEGMENTS;
+    int column = std::min((int)scaled, PERIMETER_SEGMENTS - 1);
+    float coin = scaled - column;
+    float keepProbability = aliasProbability[column];
+    bool keep = coin < keepProbability;
+
+    site = keep ? column : aliasSite[column];
+    float along = keep ? coin / keepProbability
+                       : (coin - keepProbability) /
+                             std::max(1e-6f, 1.0f - keepProbability);
+    return position + segmentStart[site] + segmentSpan[site] * along;
+}
+
 ofVec2f Potato::getSurfacePointForBubble() {
-    float x_offset = ofRandom(-size.x / 2.0f, size.x / 2.0f);
-    float y_offset = ofRandom(-size.y / 2.0f, size.y / 2.0f);
+    int site;
+    return sampleSite(random(0.0f, 1.0f), site);
+}
 
-    // Prefer edges for bubble generation
-    if (ofRandom(1.0f) < 0.90f) {
-        if (ofRandom(1.0f) < 0.5f) {
-            y_offset = ofRandom(1.0f) < 0.5f ? -size.y / 2.0f : size.y / 2.0f;
-        } else {
-            x_offset = ofRandom(1.0f) < 0.5f ? -size.x / 2.0f : size.x / 2.0f;
+void Potato::sampleBubbleSites(int count, ofVec2f* points, int* sites) {
+    // Draws first, then a branch-free gather loop
+    float uniforms[64];
+    int batchSites[64];
+    for (int start = 0; start < count; start += 64) {
+        int batch = std::min(64, count - start);
+        for (int i = 0; i < batch; i++) uniforms[i] = random(0.0f, 1.0f);
+        for (int i = 0; i < batch; i++) {
+            points[start + i] = sampleSite(uniforms[i], batchSites[i]);
+        }
+        if (sites != nullptr) {
+            std::copy(batchSites, batchSites + batch, sites + start);
         }
     }
-
-    return ofVec2f(position.x + x_offset, position.y + y_offset);
 }
 
 float Potato::getBubbleGenerationFactor(float oilTemp) {
@@ -357,6 +681,99 @@ float Potato::getBubbleGenerationFactor(float oilTemp) {
     return baseFactor;
 }
 
+int Potato::sampleBubbleReleases(float oilTemp, float dt,
+                                 float* releaseTimes, int maxCount,
+                                 float rateScale) {
+    // Rate is held over the step; arrivals are where the accumulated
+    // exposure rate * t passes successive Exp(1) thresholds, so the count
+    // over any interval is Poisson regardless of how it is divided into steps
+    float rate =
+        rateScale * MAX_BUBBLE_RATE * getBubbleGenerationFactor(oilTemp);
+    if (rate <= 0.0f) return 0;
+
+    int count = 0;
+    float t = 0.0f;
+    while (t + bubbleExposure / rate <= dt) {
+        t += bubbleExposure / rate;
+        if (count < maxCount) releaseTimes[count++] = t;
+        bubbleExposure = -log(std::max(1e-7f, 1.0f - random(0.0f, 1.0f)));
+    }
+    bubbleExposure -= (dt - t) * rate;
+    return count;
+}
+
+void Potato::setResolved(bool enable) {
+    if (enable == resolved) return;
+
+    // Lumped -> resolved: uniform profile at the lumped temperature.
+    // Resolved -> lumped: temperature already holds the profile mean.
+    // Both preserve heat content (equal-mass nodes).
+    if (enable) {
+        std::fill(nodeTemperatures, nodeTemperatures + CONDUCTION_NODES,
+                  temperature);
+    }
+    resolved = enable;
+}
+
+float Potato::getSurfaceTemperature() const {
+    return resolved ? nodeTemperatures[0] : temperature;
+}
+
+float Potato::getCoreTemperature() const {
+    return resolved ? nodeTemperatures[CONDUCTION_NODES - 1] : temperature;
+}
+
+void Potato::conduct(float dt, float oilTemp, float heatTransferCoeff) {
+    // Explicit finite differences across the half-thickness (symmetric
+    // slab, insulated at the core). Potato diffusivity ~1.4e-7 m²/s over a
+    // 5 mm half-thickness gives a diffusion rate of
+    // α / Δx² ≈ 1.4e-7 / (5e-3 / 8)² ≈ 0.36 /s per node.
+    const int n = CONDUCTION_NODES;
+    const float diffusionRate = 0.36f;
+
+    // The oil delivers exactly the lumped model's heat flux h·(T_oil - T̄),
+    // but all of it enters the surface node (1/n of the mass), so the mean
+    // follows the calibrated lumped trajectory while the profile resolves
+    // the surface-to-core gradient
+    float surfaceRate = heatTransferCoeff * n;
+
+    // Sub-step within the explicit stability limit
+    float maxStep = 0.4f / diffusionRate;
+    int numSubsteps = std::max(1, (int)ceil(dt / maxStep));
+    float h = dt / numSubsteps;
+
+    float next[CONDUCTION_NODES];
+    for (int step = 0; step < numSubsteps; step++) {
+        float mean = 0.0f;
+        for (int i = 0; i < n; i++) mean += nodeTemperatures[i];
+        mean /= n;
+
+        for (int i = 0; i < n; i++) {
+            float left = i > 0 ? nodeTemperatures[i - 1] : nodeTemperatures[i];
+            float right =
+                i < n - 1 ? nodeTemperatures[i + 1] : nodeTemperatures[i];
+            float laplacian = left - 2.0f * nodeTemperatures[i] + right;
+            next[i] = nodeTemperatures[i] + diffusionRate * laplacian * h;
+        }
+        next[0] += surfaceRate * (oilTemp - mean) * h;
+
+        // Heat the surface cannot hold above oil temperature passes inward
+        for (int i = 0; i < n - 1; i++) {
+            if (next[i] > oilTemp) {
+                next[i + 1] += next[i] - oilTemp;
+                next[i] = oilTemp;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            nodeTemperatures[i] = ofClamp(next[i], 20.0f, oilTemp);
+        }
+    }
+
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) sum += nodeTemperatures[i];
+    temperature = sum / n;
+}
+
 float Potato::getEffectiveHeatTransferCoefficient() {
     // Base coefficient calibrated to match real frying dynamics
     // h_eff ≈ 250-500 W/m²K in physical units
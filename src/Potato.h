@@ -1,7 +1,29 @@
 #pragma once
 
+#include <functional>
+#include <random>
+
 #include "ofMain.h"
 
+/**
+ * Threshold crossing detected while stepping a Potato. The time is seconds
+ * of oil contact (timeInOil), refined inside the step in which the crossing
+ * occurred rather than quantized to the step boundary.
+ *
+ *   FLOAT:        density drops below the oil density
+ *   DONE:         cookedness reaches Potato::DONE_COOKEDNESS
+ *   BUBBLING_END: bubble generation factor falls below
+ *                 Potato::BUBBLING_END_FACTOR while in oil
+ *
+ * Each type fires at most once per Potato.
+ */
+struct FryEvent {
+    enum Type { FLOAT, DONE, BUBBLING_END };
+
+    Type type;
+    float time;
+};
+
 /**
  * Simulates the thermodynamic and physical behaviour of a potato during
  * deep frying, including heat transfer, moisture evaporation, density changes,
@@ -14,6 +36,31 @@
  *   - Cookedness: Maillard reaction kinetics (quadratic temperature
  * progression)
  *
+ * Level of detail: by default temperature is lumped (one value per fry).
+ * A resolved fry additionally carries a 1D conduction profile across its
+ * half-thickness (surface to core): the lumped model's oil heat flux enters
+ * the surface node and the lumped temperature becomes the profile mean.
+ * Switching levels conserves the fry's heat content, so aggregate state
+ * carries over without a jump.
+ *
+ * Bubble release is a Poisson process with rate
+ * MAX_BUBBLE_RATE * getBubbleGenerationFactor, sampled as exact arrival
+ * times within each step, so bubble flux does not depend on step size.
+ *
+ * The outline is divided into PERIMETER_SEGMENTS segments carrying local
+ * surface moisture and crust. They follow the same kinetics as the
+ * aggregate moistureContent and crustThickness, scaled by each segment's
+ * exposure (corners and cut ends dry first; mean exposure 1), so their mean
+ * tracks the aggregates, which keep their meaning for physics, UI and
+ * telemetry. Each segment is also a nucleation site of persistent strength;
+ * bubbles start at a site drawn in O(1) from an alias table weighted by
+ * strength and local moisture and crust, with one uniform that also places
+ * the bubble along the segment.
+ *
+ * Random draws (release intervals, sites) come from the fry's own
+ * generator, seeded by whoever creates it, so fries stepped on worker
+ * threads don't share ofRandom's global state and runs are reproducible.
+ *
  * References:
  *   [1] Pedreschi, F., et al. (2005). "Modeling water loss during frying
  *       of potato slices." Int. J. Food Properties, 8(2), 289-299.
@@ -25,7 +72,14 @@
  */
 class Potato {
    public:
-    Potato(ofVec2f startPos, ofVec2f sz);
+    static constexpr float DONE_COOKEDNESS = 0.70f;
+    static constexpr float BUBBLING_END_FACTOR = 0.02f;
+    static const int CONDUCTION_NODES = 8;
+    static constexpr float MAX_BUBBLE_RATE = 1200.0f;  // bubbles/s at factor 1
+    static const int PERIMETER_SEGMENTS = 32;
+    static constexpr float SITE_TABLE_INTERVAL = 0.25f;
+
+    Potato(ofVec2f startPos, ofVec2f sz, unsigned int seed);
 
     void update(float dt, float oilTemp, float oilSurfaceY, float oilDensity,
                 float basketBottomY);
@@ -33,9 +87,23 @@ class Potato {
 
     ofColor getCookingColor();
     ofVec2f getSurfacePointForBubble();
+    // sites, if given, receives each point's perimeter segment
+    void sampleBubbleSites(int count, ofVec2f* points, int* sites = nullptr);
     float getBubbleGenerationFactor(float oilTemp);
+    // rateScale thins the releases, e.g. to the fraction a caller samples
+    // individually
+    int sampleBubbleReleases(float oilTemp, float dt, float* releaseTimes,
+                             int maxCount, float rateScale = 1.0f);
     float getEffectiveHeatTransferCoefficient();
 
+    // Uniform draw from the fry's own generator, e.g. for thinning its
+    // releases
+    float random(float low, float high);
+
+    void setResolved(bool enable);
+    float getSurfaceTemperature() const;
+    float getCoreTemperature() const;
+
     ofVec2f position;
     ofVec2f size;
     ofVec2f velocity;
@@ -49,6 +117,77 @@ class Potato {
 
     bool isInOil;
     bool vigorousBubblingPhase;
+    bool resolved;
+    bool selected;  // Part of the viewer's multi-fry selection
+    unsigned int firedEvents;  // bitmask of FryEvent::Type already emitted
+
+    // Unit-rate exposure left before the next bubble release, Exp(1)
+    float bubbleExposure;
+
+    // Perimeter segments, as offsets from position: segment k spans
+    // segmentStart[k] .. segmentStart[k] + segmentSpan[k], clockwise
+    ofVec2f segmentStart[PERIMETER_SEGMENTS];
+    ofVec2f segmentSpan[PERIMETER_SEGMENTS];
+    float segmentExposure[PERIMETER_SEGMENTS];  // relative drying rate
+    float segmentMoisture[PERIMETER_SEGMENTS];  // local surface fraction
+    float segmentCrust[PERIMETER_SEGMENTS];     // [0, 1] normalized
+
+    // Persistent cavity strength of each segment's nucleation site
+    float siteActivity[PERIMETER_SEGMENTS];
+
+    // Alias table over the sites (Vose): column k keeps site k with
+    // probability aliasProbability[k], otherwise yields aliasSite[k].
+    // Rebuilt from local state every SITE_TABLE_INTERVAL s in oil.
+    float aliasProbability[PERIMETER_SEGMENTS];
+    int aliasSite[PERIMETER_SEGMENTS];
+    float siteShare[PERIMETER_SEGMENTS];  // Each site's probability
+    float siteTableAge;
 
     ofColor currentColor;
+
+    // Resolved level only: surface (0) to core, °C
+    float nodeTemperatures[CONDUCTION_NODES];
+
+    // Invoked from update() for each detected FryEvent, in time order
+    std::function<void(const FryEvent&)> onEvent;
+
+   private:
+    // Small state (unlike mt19937) since fries are copied by value
+    std::minstd_rand rng;
+
+    // Bulk state that integrate() advances and the event indicators read;
+    // enough to re-step a fry while refining an event time
+    struct StepState {
+        ofVec2f position;
+        ofVec2f velocity;
+        float moistureContent;
+        float temperature;
+        float cookedness;
+        float crustThickness;
+        float density;
+        float timeInOil;
+        bool isInOil;
+        bool vigorousBubblingPhase;
+        float nodeTemperatures[CONDUCTION_NODES];
+        ofColor currentColor;
+    };
+
+    StepState saveStep() const;
+    void restoreStep(const StepState& state);
+    void buildPerimeter();
+    void updatePerimeter(float evaporation, float crustFormation);
+    void rebuildSiteTable();
+    void buildAliasTable(const float* weights);
+    ofVec2f sampleSite(float u, int& site) const;
+    void conduct(float dt, float oilTemp, float heatTransferCoeff);
+    // updateSurface = false skips the perimeter and site table, for probes
+    void integrate(float dt, float oilTemp, float oilSurfaceY,
+                   float oilDensity, float basketBottomY,
+                   bool updateSurface = true);
+    float eventIndicator(FryEvent::Type type, float oilTemp,
+                         float oilDensity);
+    float refineEventTime(const StepState& start, FryEvent::Type type,
+                          float gStart, float gEnd, float dt, float oilTemp,
+                          float oilSurfaceY, float oilDensity,
+                          float basketBottomY);
 };
@@ -0,0 +1,267 @@
+#include "RecipeSearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+TemperatureSchedule Recipe::getSchedule() const {
+    TemperatureSchedule schedule;
+    schedule.switchTimes = {0.0f, switchTime};
+    schedule.targets = {dropTemperature, finishTemperature};
+    return schedule;
+}
+
+RecipeSearch::RecipeSearch(int numThreads, unsigned int seed)
+    : pool(numThreads),
+      rng(seed),
+      generation(0),
+      firstUnscored(0),
+      nextUnscored(0) {
+    // Golden and cooked through, crisp shell, not dried out
+    minCookedness = Potato::DONE_COOKEDNESS;
+    minCrust = 0.70f;
+    minMoisture = 0.25f;
+    maxMoisture = 0.55f;
+
+    minTemperature = 160.0f;
+    maxTemperature = 190.0f;
+    minFryTime = 20.0f;
+    maxFryTime = 240.0f;
+
+    populationSize = 2000;
+    numGenerations = 40;
+    rolloutStep = 0.25f;
+
+    initialOilTemperature = 175.0f;
+    oilSurfaceY = HEADLESS_OIL_SURFACE_Y;
+    basketBottomY = HEADLESS_BASKET_BOTTOM_Y;
+}
+
+void RecipeSearch::run() {
+    start();
+    while (runGeneration(pool)) {}
+}
+
+void RecipeSearch::start() {
+    population.assign(populationSize, RecipeScore());
+    for (auto& member : population) {
+        member.recipe = randomRecipe();
+    }
+
+    best.clear();
+    pareto.clear();
+    generation = 0;
+    firstUnscored = 0;
+    nextUnscored = 0;
+    generationStart = std::chrono::steady_clock::now();
+}
+
+bool RecipeSearch::runGeneration(WorkerPool& workers) {
+    return runBatch(workers, populationSize);
+}
+
+bool RecipeSearch::runBatch(WorkerPool& workers, int maxCount) {
+    if (generation >= numGenerations) return false;
+
+    int end = std::min(populationSize, nextUnscored + std::max(1, maxCount));
+    evaluate(workers, population, nextUnscored, end);
+    nextUnscored = end;
+    if (nextUnscored < populationSize) return true;
+    return endGeneration();
+}
+
+bool RecipeSearch::endGeneration() {
+    updateArchive(population, firstUnscored);
+
+    std::sort(population.begin(), population.end(),
+              [this](const RecipeScore& a, const RecipeScore& b) {
+                  return getFitness(a) < getFitness(b);
+              });
+
+    auto endTime = std::chrono::steady_clock::now();
+    float millis = std::chrono::duration<float, std::milli>(endTime -
+                                                            generationStart)
+                       .count();
+    ofLogNotice("RecipeSearch")
+        << "generation " << generation << ": best fitness "
+        << getFitness(population[0]) << ", pareto size " << pareto.size()
+        << ", " << millis << " ms";
+
+    if (generation == numGenerations - 1) {
+        generation++;
+        return false;
+    }
+
+    // Elites survive unchanged; mutation narrows as the search converges
+    float progress = (float)generation / std::max(1, numGenerations - 1);
+    float sigma = ofLerp(0.15f, 0.02f, progress);
+    int numElites = std::max(1, populationSize / 20);
+
+    std::vector<RecipeScore> next(population.begin(),
+                                  population.begin() + numElites);
+    next.resize(populationSize);
+    for (int i = numElites; i < populationSize; i++) {
+        next[i].recipe = breed(population, sigma);
+    }
+    population.swap(next);
+    firstUnscored = numElites;
+    nextUnscored = numElites;
+    generation++;
+    generationStart = endTime;
+    return true;
+}
+
+float RecipeSearch::getProgress() const {
+    return (float)generation / std::max(1, numGenerations);
+}
+
+void RecipeSearch::evaluate(WorkerPool& workers,
+                            std::vector<RecipeScore>& scores, int firstIndex,
+                            int endIndex) const {
+    Potato fry = makeDroppedFry(oilSurfaceY, 1);
+    Oil oil(oilSurfaceY, initialOilTemperature);
+
+    workers.parallelFor(endIndex - firstIndex, [&](int i) {
+        RecipeScore& score = scores[firstIndex + i];
+        score.result =
+            rolloutFry(fry, oil, score.recipe.getSchedule(), basketBottomY,
+                       score.recipe.fryTime, rolloutStep, false);
+        score.violation = getViolation(score.result);
+    });
+}
+
+float RecipeSearch::getViolation(const RolloutResult& result) const {
+    float violation = 0.0f;
+    violation += std::max(0.0f, minCookedness - result.cookednessAtEnd);
+    violation += std::max(0.0f, minCrust - result.crustAtEnd);
+    violation += std::max(0.0f, minMoisture - result.moistureAtEnd);
+    violation += std::max(0.0f, result.moistureAtEnd - maxMoisture);
+    return violation;
+}
+
+float RecipeSearch::getFitness(const RecipeScore& score) const {
+    // Infeasible recipes rank behind every feasible one
+    float penalty = score.violation > 0.0f ? maxFryTime : 0.0f;
+    return score.recipe.fryTime + penalty + score.violation * 1000.0f;
+}
+
+Recipe RecipeSearch::randomRecipe() {
+    std::uniform_real_distribution<float> temperature(minTemperature,
+                                                      maxTemperature);
+    std::uniform_real_distribution<float> time(minFryTime, maxFryTime);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    Recipe recipe;
+    recipe.dropTemperature = temperature(rng);
+    recipe.finishTemperature = temperature(rng);
+    recipe.fryTime = time(rng);
+    recipe.switchTime = recipe.fryTime * unit(rng);
+    return recipe;
+}
+
+const RecipeScore& RecipeSearch::tournament(
+    const std::vector<RecipeScore>& population) {
+    std::uniform_int_distribution<int> pick(0, (int)population.size() - 1);
+    const RecipeScore* winner = &population[pick(rng)];
+    for (int i = 0; i < 2; i++) {
+        const RecipeScore& challenger = population[pick(rng)];
+        if (getFitness(challenger) < getFitness(*winner)) {
+            winner = &challenger;
+        }
+    }
+    return *winner;
+}
+
+Recipe RecipeSearch::breed(const std::vector<RecipeScore>& population,
+                           float sigma) {
+    const Recipe& a = tournament(population).recipe;
+    const Recipe& b = tournament(population).recipe;
+
+    // Blend crossover followed by Gaussian mutation scaled to each range
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, sigma);
+    float temperatureRange = maxTemperature - minTemperature;
+    float timeRange = maxFryTime - minFryTime;
+
+    Recipe child;
+    child.dropTemperature = ofLerp(a.dropTemperature, b.dropTemperature,
+                                   unit(rng)) +
+                            noise(rng) * temperatureRange;
+    child.finishTemperature = ofLerp(a.finishTemperature,
+                                     b.finishTemperature, unit(rng)) +
+                              noise(rng) * temperatureRange;
+    child.fryTime =
+        ofLerp(a.fryTime, b.fryTime, unit(rng)) + noise(rng) * timeRange;
+    child.switchTime =
+        ofLerp(a.switchTime, b.switchTime, unit(rng)) + noise(rng) * timeRange;
+
+    clampRecipe(child);
+    return child;
+}
+
+void RecipeSearch::clampRecipe(Recipe& recipe) const {
+    recipe.dropTemperature =
+        ofClamp(recipe.dropTemperature, minTemperature, maxTemperature);
+    recipe.finishTemperature =
+        ofClamp(recipe.finishTemperature, minTemperature, maxTemperature);
+    recipe.fryTime = ofClamp(recipe.fryTime, minFryTime, maxFryTime);
+    recipe.switchTime = ofClamp(recipe.switchTime, 0.0f, recipe.fryTime);
+}
+
+void RecipeSearch::updateArchive(const std::vector<RecipeScore>& population,
+                                 int firstIndex) {
+    for (size_t i = firstIndex; i < population.size(); i++) {
+        const RecipeScore& score = population[i];
+        if (score.violation <= 0.0f) {
+            best.push_back(score);
+            pareto.push_back(score);
+        }
+    }
+
+    // Fastest feasible recipes, trimmed to a short list
+    std::sort(best.begin(), best.end(),
+              [](const RecipeScore& a, const RecipeScore& b) {
+                  return a.recipe.fryTime < b.recipe.fryTime;
+              });
+    if (best.size() > 20) best.resize(20);
+
+    // Non-dominated in (fry time, thermal dose): sweep by time and keep
+    // each recipe whose dose beats every faster one
+    std::sort(pareto.begin(), pareto.end(),
+              [](const RecipeScore& a, const RecipeScore& b) {
+                  if (a.recipe.fryTime != b.recipe.fryTime) {
+                      return a.recipe.fryTime < b.recipe.fryTime;
+                  }
+                  return a.result.thermalDose < b.result.thermalDose;
+              });
+    std::vector<RecipeScore> front;
+    for (const auto& score : pareto) {
+        if (front.empty() ||
+            score.result.thermalDose < front.back().result.thermalDose) {
+            front.push_back(score);
+        }
+    }
+    pareto.swap(front);
+}
+
+bool RecipeSearch::writeCsv(const std::string& path,
+                            const std::vector<RecipeScore>& scores) const {
+    std::ofstream file(path);
+    if (!file) {
+        ofLogError("RecipeSearch") << "cannot write " << path;
+        return false;
+    }
+
+    file << "drop_c,finish_c,switch_s,fry_s,cookedness,moisture,crust,"
+            "thermal_dose,done_s\n";
+    for (const auto& score : scores) {
+        const Recipe& r = score.recipe;
+        const RolloutResult& result = score.result;
+        file << r.dropTemperature << "," << r.finishTemperature << ","
+             << r.switchTime << "," << r.fryTime << ","
+             << result.cookednessAtEnd << "," << result.moistureAtEnd << ","
+             << result.crustAtEnd << "," << result.thermalDose << ","
+             << result.doneTime << "\n";
+    }
+    return true;
+}
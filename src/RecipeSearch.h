@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Rollout.h"
+#include "WorkerPool.h"
+
+/**
+ * Two-stage frying recipe: drop at the first set point, switch to the
+ * second after switchTime, and lift the basket at fryTime (seconds).
+ */
+struct Recipe {
+    float dropTemperature;
+    float finishTemperature;
+    float switchTime;
+    float fryTime;
+
+    TemperatureSchedule getSchedule() const;
+};
+
+/**
+ * Evaluated recipe. violation is the summed, normalized amount by which the
+ * fry at lift misses the cookedness, moisture and crust constraints; a
+ * recipe is feasible when it is zero.
+ */
+struct RecipeScore {
+    Recipe recipe;
+    RolloutResult result;
+    float violation;
+};
+
+/**
+ * Offline evolutionary search over two-stage temperature schedules and fry
+ * times. Every generation evaluates the whole population as independent
+ * headless rollouts on a WorkerPool, minimizing fry time subject to the
+ * quality constraints at lift, and keeps an archive of feasible recipes
+ * that are Pareto-optimal in fry time vs. oil thermal dose (browning).
+ *
+ * run() does the whole search on the search's own pool. Callers sharing a
+ * pool with other work can instead call start() and then runBatch() until
+ * it returns false, scoring a generation a few recipes at a time.
+ */
+class RecipeSearch {
+   public:
+    explicit RecipeSearch(int numThreads = 0, unsigned int seed = 1);
+
+    void run();
+    void start();
+    bool runGeneration(WorkerPool& workers);
+
+    // Scores up to maxCount more recipes of the current generation, then
+    // ends the generation once all are scored; false when the search is done
+    bool runBatch(WorkerPool& workers, int maxCount);
+    float getProgress() const;
+
+    // Scores recipes [firstIndex, endIndex) as independent rollouts
+    void evaluate(WorkerPool& workers, std::vector<RecipeScore>& scores,
+                  int firstIndex, int endIndex) const;
+
+    bool writeCsv(const std::string& path,
+                  const std::vector<RecipeScore>& scores) const;
+
+    // Constraints on the fry at lift
+    float minCookedness;
+    float minCrust;
+    float minMoisture;
+    float maxMoisture;
+
+    // Search space
+    float minTemperature;
+    float maxTemperature;
+    float minFryTime;
+    float maxFryTime;
+
+    int populationSize;
+    int numGenerations;
+    float rolloutStep;
+
+    // Fryer geometry and starting state of each simulated drop
+    float initialOilTemperature;
+    float oilSurfaceY;
+    float basketBottomY;
+
+    std::vector<RecipeScore> best;    // feasible, fastest first
+    std::vector<RecipeScore> pareto;  // fry time ascending, dose descending
+
+   private:
+    float getViolation(const RolloutResult& result) const;
+    float getFitness(const RecipeScore& score) const;
+    Recipe randomRecipe();
+    Recipe breed(const std::vector<RecipeScore>& population, float sigma);
+    const RecipeScore& tournament(const std::vector<RecipeScore>& population);
+    void clampRecipe(Recipe& recipe) const;
+    void updateArchive(const std::vector<RecipeScore>& population,
+                       int firstIndex);
+    bool endGeneration();
+
+    WorkerPool pool;
+    std::mt19937 rng;
+
+    // Search state between generations; elites carried over from the
+    // previous generation (before firstUnscored) are already scored, and
+    // members from nextUnscored on are still waiting for a batch
+    std::vector<RecipeScore> population;
+    int generation;
+    int firstUnscored;
+    int nextUnscored;
+    std::chrono::steady_clock::time_point generationStart;
+};
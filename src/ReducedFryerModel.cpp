@@ -0,0 +1,258 @@
+#include "ReducedFryerModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+
+// Bracketing index and weight of x on a sorted axis, clamped to its ends
+void locate(const std::vector<float>& axis, float x, int& i, float& f) {
+    if (axis.size() < 2 || x <= axis.front()) {
+        i = 0;
+        f = 0.0f;
+        return;
+    }
+    if (x >= axis.back()) {
+        i = (int)axis.size() - 2;
+        f = 1.0f;
+        return;
+    }
+    i = (int)(std::upper_bound(axis.begin(), axis.end(), x) - axis.begin()) -
+        1;
+    f = (x - axis[i]) / (axis[i + 1] - axis[i]);
+}
+
+BasketCycle lerpCycle(const BasketCycle& a, const BasketCycle& b, float f) {
+    BasketCycle c;
+    c.cookTime = ofLerp(a.cookTime, b.cookTime, f);
+    c.liftTemperature = ofLerp(a.liftTemperature, b.liftTemperature, f);
+    c.minOilTemperature = ofLerp(a.minOilTemperature, b.minOilTemperature, f);
+    c.heaterEnergy = ofLerp(a.heaterEnergy, b.heaterEnergy, f);
+    c.polarCompoundsAdded =
+        ofLerp(a.polarCompoundsAdded, b.polarCompoundsAdded, f);
+    return c;
+}
+
+float relativeError(float reduced, float full) {
+    return fabs(reduced - full) / std::max(fabs(full), 1e-6f);
+}
+
+}  // namespace
+
+ReducedFryerModel::ReducedFryerModel() {
+    setPoints = {160, 165, 170, 175, 180, 185, 190};
+    dropOffsets = {0.0f, 2.5f, 5.0f, 7.5f};
+    basketMasses = {0.3f, 0.45f, 0.6f, 0.75f, 0.9f, 1.2f};
+}
+
+const BasketCycle& ReducedFryerModel::getCycle(int s, int d, int m) const {
+    return cycles[(s * dropOffsets.size() + d) * basketMasses.size() + m];
+}
+
+void ReducedFryerModel::fit(WorkerPool& pool, const FryerDayConfig& base,
+                            float dt) {
+    int numCycles =
+        (int)(setPoints.size() * dropOffsets.size() * basketMasses.size());
+    cycles.assign(numCycles, BasketCycle());
+
+    pool.parallelFor(numCycles, [&](int i) {
+        int m = i % basketMasses.size();
+        int d = (i / basketMasses.size()) % dropOffsets.size();
+        int s = i / (basketMasses.size() * dropOffsets.size());
+
+        FryerDayConfig config = base;
+        config.setPoint = setPoints[s];
+        config.basketMass = basketMasses[m];
+        cycles[i] = simulateBasketCycle(
+            config, setPoints[s] - dropOffsets[d], dt);
+    });
+}
+
+BasketCycle ReducedFryerModel::lookupCycle(float setPoint, float dropOffset,
+                                           float basketMass) const {
+    // Trilinear interpolation
+    int s, d, m;
+    float fs, fd, fm;
+    locate(setPoints, setPoint, s, fs);
+    locate(dropOffsets, dropOffset, d, fd);
+    locate(basketMasses, basketMass, m, fm);
+
+    BasketCycle planes[2];
+    for (int ds = 0; ds < 2; ds++) {
+        BasketCycle rows[2];
+        for (int dd = 0; dd < 2; dd++) {
+            rows[dd] = lerpCycle(getCycle(s + ds, d + dd, m),
+                                 getCycle(s + ds, d + dd, m + 1), fm);
+        }
+        planes[ds] = lerpCycle(rows[0], rows[1], fd);
+    }
+    return lerpCycle(planes[0], planes[1], fs);
+}
+
+float ReducedFryerModel::getOxidationRate(float temperature) const {
+    // Same thermo-oxidative law as Oil::degrade, in % TPC per second
+    return 0.15f * pow(2.0f, (temperature - 180.0f) / 10.0f) / 3600.0f;
+}
+
+FryerDayResult ReducedFryerModel::simulateDay(
+    const FryerDayConfig& config) const {
+    float heatingRate = config.heaterPower / config.oilHeatCapacity;
+    float readyTemperature = config.setPoint - config.readyTolerance;
+    float serviceEnd = config.hourlyBaskets.size() * 3600.0f;
+    float hardStop = serviceEnd + 4.0f * 3600.0f;
+    float idleRate = getOxidationRate(config.setPoint);
+
+    FryerDayResult result;
+    result.basketsCooked = 0;
+    result.heaterEnergy = 0.0f;
+    result.polarCompounds = config.initialPolarCompounds;
+    result.minOilTemperature = config.setPoint;
+
+    float totalCookTime = 0.0f;
+    float t = 0.0f;
+    float temperature = config.setPoint;
+    float handledAt = 0.0f;
+    int nextDemand = 0;
+    int queued = 0;
+
+    // Oil heats at full power up to the set point, then holds
+    auto advanceIdle = [&](float until) {
+        float duration = until - t;
+        if (duration <= 0.0f) return;
+        float ramp = std::min(duration,
+                              (config.setPoint - temperature) / heatingRate);
+        float reached = temperature + ramp * heatingRate;
+        result.heaterEnergy +=
+            (reached - temperature) * config.oilHeatCapacity;
+        result.polarCompounds +=
+            0.5f * (getOxidationRate(temperature) + idleRate) * ramp +
+            idleRate * (duration - ramp);
+        temperature = reached;
+        t = until;
+    };
+
+    // Demand is evenly spaced within each hour, as in getDemandTimes
+    int numHours = (int)config.hourlyBaskets.size();
+    int hour = 0;
+    int indexInHour = 0;
+    auto nextDemandTime = [&]() -> float {
+        while (hour < numHours &&
+               indexInHour >= (int)round(config.hourlyBaskets[hour])) {
+            hour++;
+            indexInHour = 0;
+        }
+        if (hour >= numHours) return -1.0f;
+        int count = (int)round(config.hourlyBaskets[hour]);
+        return (hour + (indexInHour + 0.5f) / count) * 3600.0f;
+    };
+
+    float pendingDemand = nextDemandTime();
+    while (t < hardStop) {
+        while (pendingDemand >= 0.0f && pendingDemand <= t) {
+            queued++;
+            nextDemand++;
+            indexInHour++;
+            pendingDemand = nextDemandTime();
+        }
+
+        if (queued == 0) {
+            if (pendingDemand < 0.0f) break;
+            advanceIdle(pendingDemand);
+            continue;
+        }
+
+        // Drop once handled and recovered
+        float recoveredAt =
+            t + std::max(0.0f, readyTemperature - temperature) / heatingRate;
+        advanceIdle(std::max(handledAt, recoveredAt));
+        temperature = std::max(temperature, readyTemperature);
+
+        BasketCycle cycle = lookupCycle(
+            config.setPoint, config.setPoint - temperature, config.basketMass);
+        queued--;
+        t += cycle.cookTime;
+        temperature = cycle.liftTemperature;
+        result.heaterEnergy += cycle.heaterEnergy;
+        result.polarCompounds += cycle.polarCompoundsAdded;
+        result.minOilTemperature =
+            std::min(result.minOilTemperature, cycle.minOilTemperature);
+        result.basketsCooked++;
+        totalCookTime += cycle.cookTime;
+        handledAt = t + config.basketHandlingTime;
+    }
+
+    if (pendingDemand < 0.0f && queued == 0) {
+        advanceIdle(std::max(t, serviceEnd));
+    }
+
+    result.basketsDemanded = nextDemand;
+    while (nextDemandTime() >= 0.0f) {
+        result.basketsDemanded++;
+        indexInHour++;
+    }
+    result.meanCookTime =
+        result.basketsCooked > 0 ? totalCookTime / result.basketsCooked : 0.0f;
+    result.endTime = t;
+    return result;
+}
+
+std::string ReducedFryerModel::validate(WorkerPool& pool,
+                                        const FryerDayConfig& base,
+                                        float dt) const {
+    const float demandScales[] = {0.5f, 1.0f, 1.5f};
+    const float validationSetPoints[] = {168.0f, 175.0f, 182.0f};
+    const float validationMasses[] = {0.5f, 0.6f, 0.8f};
+
+    std::vector<FryerDayConfig> configs;
+    for (float scale : demandScales) {
+        for (float setPoint : validationSetPoints) {
+            for (float mass : validationMasses) {
+                FryerDayConfig config = base;
+                for (auto& rate : config.hourlyBaskets) rate *= scale;
+                config.setPoint = setPoint;
+                config.basketMass = mass;
+                configs.push_back(config);
+            }
+        }
+    }
+
+    std::vector<FryerDayResult> full(configs.size());
+    pool.parallelFor((int)configs.size(), [&](int i) {
+        full[i] = simulateFryerDay(configs[i], dt);
+    });
+
+    const int numMetrics = 5;
+    const char* names[numMetrics] = {"baskets cooked", "heater energy",
+                                     "TPC increase", "mean cook time",
+                                     "min oil temperature"};
+    float meanError[numMetrics] = {0};
+    float maxError[numMetrics] = {0};
+
+    for (size_t i = 0; i < configs.size(); i++) {
+        FryerDayResult reduced = simulateDay(configs[i]);
+        float initial = configs[i].initialPolarCompounds;
+        float errors[numMetrics] = {
+            relativeError((float)reduced.basketsCooked,
+                          (float)full[i].basketsCooked),
+            relativeError(reduced.heaterEnergy, full[i].heaterEnergy),
+            relativeError(reduced.polarCompounds - initial,
+                          full[i].polarCompounds - initial),
+            relativeError(reduced.meanCookTime, full[i].meanCookTime),
+            relativeError(reduced.minOilTemperature,
+                          full[i].minOilTemperature)};
+        for (int k = 0; k < numMetrics; k++) {
+            meanError[k] += errors[k] / configs.size();
+            maxError[k] = std::max(maxError[k], errors[k]);
+        }
+    }
+
+    std::ostringstream report;
+    report << "reduced vs full model over " << configs.size()
+           << " fryer-days (relative error, mean / max)\n";
+    for (int k = 0; k < numMetrics; k++) {
+        report << "  " << names[k] << ": " << meanError[k] * 100.0f << "% / "
+               << maxError[k] * 100.0f << "%\n";
+    }
+    return report.str();
+}
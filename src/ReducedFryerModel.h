@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "FryerDay.h"
+#include "WorkerPool.h"
+
+/**
+ * Reduced-order fryer model for chain-scale planning. The basket cycle is
+ * replaced by tables fitted from full-physics cycles (simulateBasketCycle)
+ * over set point, drop temperature below set point, and basket mass; idle
+ * and recovery periods are closed-form heater ramps. A fryer-day then costs
+ * one table lookup per basket instead of time-stepping oil and fries.
+ *
+ * validate() runs the full and reduced models side by side over a grid of
+ * demand levels, set points and basket masses and reports relative errors.
+ */
+class ReducedFryerModel {
+   public:
+    ReducedFryerModel();
+
+    void fit(WorkerPool& pool, const FryerDayConfig& base, float dt);
+    FryerDayResult simulateDay(const FryerDayConfig& config) const;
+    std::string validate(WorkerPool& pool, const FryerDayConfig& base,
+                         float dt) const;
+
+    // Table axes
+    std::vector<float> setPoints;     // °C
+    std::vector<float> dropOffsets;   // °C below set point at drop
+    std::vector<float> basketMasses;  // kg
+
+   private:
+    BasketCycle lookupCycle(float setPoint, float dropOffset,
+                            float basketMass) const;
+    const BasketCycle& getCycle(int s, int d, int m) const;
+    float getOxidationRate(float temperature) const;
+
+    std::vector<BasketCycle> cycles;  // [setPoint][dropOffset][basketMass]
+};
@@ -0,0 +1,69 @@
+#include "Rollout.h"
+
+#include <algorithm>
+
+float TemperatureSchedule::getTarget(float t) const {
+    float target = targets.empty() ? 175.0f : targets[0];
+    for (size_t i = 1; i < switchTimes.size() && i < targets.size(); i++) {
+        if (t < switchTimes[i]) break;
+        target = targets[i];
+    }
+    return target;
+}
+
+Potato makeDroppedFry(float oilSurfaceY, unsigned int seed, ofVec2f size) {
+    Potato fry(ofVec2f(512.0f, oilSurfaceY - 80.0f), size, seed);
+    fry.velocity = ofVec2f(0, 100.0f);
+    return fry;
+}
+
+RolloutResult rolloutFry(Potato fry, Oil oil,
+                         const TemperatureSchedule& schedule,
+                         float basketBottomY, float maxTime, float dt,
+                         bool stopAtDone) {
+    RolloutResult result;
+    result.doneTime = -1.0f;
+    result.moistureAtDone = fry.moistureContent;
+    result.crustAtDone = fry.crustThickness;
+    result.thermalDose = 0.0f;
+
+    // Already-done fries report completion immediately
+    if (fry.cookedness >= Potato::DONE_COOKEDNESS) {
+        result.doneTime = 0.0f;
+        if (stopAtDone) {
+            result.cookednessAtEnd = fry.cookedness;
+            result.moistureAtEnd = fry.moistureContent;
+            result.crustAtEnd = fry.crustThickness;
+            return result;
+        }
+    }
+
+    float t = 0.0f;
+    float step = dt;
+    bool done = false;
+    fry.firedEvents &= ~(1u << FryEvent::DONE);
+    fry.onEvent = [&](const FryEvent& event) {
+        if (event.type != FryEvent::DONE) return;
+        // Event time is in oil-contact seconds; convert to rollout time
+        result.doneTime = t + step - (fry.timeInOil - event.time);
+        result.moistureAtDone = fry.moistureContent;
+        result.crustAtDone = fry.crustThickness;
+        done = stopAtDone;
+    };
+
+    while (t < maxTime && !done) {
+        // Final step is shortened to land exactly on maxTime
+        step = std::min(dt, maxTime - t);
+        oil.approachTarget(schedule.getTarget(t), step);
+        // Browning/acrylamide proxy: exposure above the 175 °C guidance
+        result.thermalDose += std::max(0.0f, oil.temperature - 175.0f) * step;
+        fry.update(step, oil.temperature, oil.surfaceY, oil.getDensity(),
+                   basketBottomY);
+        t += step;
+    }
+
+    result.cookednessAtEnd = fry.cookedness;
+    result.moistureAtEnd = fry.moistureContent;
+    result.crustAtEnd = fry.crustThickness;
+    return result;
+}
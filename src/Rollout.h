@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "Oil.h"
+#include "Potato.h"
+
+// Fryer geometry of the default 1024x768 window, used by headless runs
+const float HEADLESS_OIL_SURFACE_Y = 315.0f;
+const float HEADLESS_BASKET_BOTTOM_Y = 508.8f;
+
+/**
+ * Piecewise-constant heater set point. Segment i holds targets[i] from
+ * switchTimes[i] (seconds from rollout start) until the next switch time;
+ * the first switch time is expected to be 0.
+ */
+struct TemperatureSchedule {
+    std::vector<float> switchTimes;
+    std::vector<float> targets;
+
+    float getTarget(float t) const;
+};
+
+/**
+ * Outcome of fast-forwarding one fry under a schedule. Times are seconds
+ * from rollout start; doneTime is refined by the fry's DONE event.
+ */
+struct RolloutResult {
+    float doneTime;  // -1 if not done within the horizon
+    float moistureAtDone;
+    float crustAtDone;
+    float thermalDose;  // °C·s of oil above 175 °C until the rollout stops
+    float cookednessAtEnd;
+    float moistureAtEnd;
+    float crustAtEnd;
+};
+
+/**
+ * Raw fry released above the oil surface, as dropped with SPACE in the
+ * viewer. The seed drives the fry's own random draws.
+ */
+Potato makeDroppedFry(float oilSurfaceY, unsigned int seed,
+                      ofVec2f size = ofVec2f(120, 20));
+
+/**
+ * Headless fast-forward of a fry and its oil: copies both, steps them with
+ * a fixed large step under the schedule, and stops at maxTime or, when
+ * stopAtDone is set, at the DONE event. No rendering, bubbles or UI state
+ * are touched, so rollouts are safe to run concurrently on a WorkerPool.
+ */
+RolloutResult rolloutFry(Potato fry, Oil oil,
+                         const TemperatureSchedule& schedule,
+                         float basketBottomY, float maxTime, float dt,
+                         bool stopAtDone = true);
@@ -0,0 +1,217 @@
+#include "Scenario.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "ofMain.h"
+
+namespace {
+
+// Slack for comparing accumulated step times (double) against wake times
+const double TIME_EPSILON = 1e-9;
+
+}  // namespace
+
+void Scenario::promise_type::unhandled_exception() {
+    // Ends only this scenario; its fryer keeps running under the thermostat
+    try {
+        throw;
+    } catch (const std::exception& e) {
+        ofLogError("Scenario") << "scenario stopped: " << e.what();
+    } catch (...) {
+        ofLogError("Scenario") << "scenario stopped by an unknown exception";
+    }
+}
+
+Scenario::Scenario(Scenario&& other) noexcept : handle(other.handle) {
+    other.handle = nullptr;
+}
+
+Scenario& Scenario::operator=(Scenario&& other) noexcept {
+    if (this != &other) {
+        if (handle) handle.destroy();
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+Scenario::~Scenario() {
+    if (handle) handle.destroy();
+}
+
+ScenarioContext::ScenarioContext(ScenarioRunner* runner, int index,
+                                 const FryerDayConfig& config)
+    : fryer(config),
+      index(index),
+      runner(runner),
+      waitKind(WAIT_NONE),
+      waitValue(0.0f),
+      waitEvent(FryEvent::DONE) {}
+
+bool ScenarioContext::Wait::await_ready() const {
+    const ScriptedFryer& fryer = context->fryer;
+    switch (kind) {
+        case WAIT_TIME:
+            return value <= fryer.time + TIME_EPSILON;
+        case WAIT_OIL_ABOVE:
+            return fryer.oil.temperature >= value;
+        case WAIT_OIL_BELOW:
+            return fryer.oil.temperature <= value;
+        default:
+            return false;
+    }
+}
+
+void ScenarioContext::Wait::await_suspend(std::coroutine_handle<>) const {
+    context->runner->suspend(*context, kind, value, event);
+}
+
+ScenarioContext::Wait ScenarioContext::at(double time) {
+    return {this, WAIT_TIME, time, FryEvent::DONE};
+}
+
+ScenarioContext::Wait ScenarioContext::after(float seconds) {
+    return {this, WAIT_TIME, fryer.time + seconds, FryEvent::DONE};
+}
+
+ScenarioContext::Wait ScenarioContext::event(FryEvent::Type type) {
+    return {this, WAIT_EVENT, 0.0f, type};
+}
+
+ScenarioContext::Wait ScenarioContext::oilAtLeast(float temperature) {
+    return {this, WAIT_OIL_ABOVE, temperature, FryEvent::DONE};
+}
+
+ScenarioContext::Wait ScenarioContext::oilAtMost(float temperature) {
+    return {this, WAIT_OIL_BELOW, temperature, FryEvent::DONE};
+}
+
+bool ScenarioContext::isStepConditionMet() const {
+    switch (waitKind) {
+        case WAIT_EVENT:
+            return fryer.hasFired(waitEvent);
+        case WAIT_OIL_ABOVE:
+            return fryer.oil.temperature >= waitValue;
+        case WAIT_OIL_BELOW:
+            return fryer.oil.temperature <= waitValue;
+        default:
+            return false;
+    }
+}
+
+ScenarioRunner::ScenarioRunner(int numThreads)
+    : pool(new WorkerPool(numThreads)), time(0.0f), numResumes(0) {}
+
+ScenarioRunner::ScenarioRunner(SharedPool) : time(0.0f), numResumes(0) {}
+
+ScenarioContext& ScenarioRunner::addFryer(const FryerDayConfig& config) {
+    int index = (int)fryers.size();
+    fryers.emplace_back(new ScenarioContext(this, index, config));
+    fryers.back()->fryer.time = time;
+    return *fryers.back();
+}
+
+void ScenarioRunner::start(ScenarioContext& context, Scenario scenario) {
+    context.scenario = std::move(scenario);
+    resume(context);
+}
+
+void ScenarioRunner::step(float dt) { step(pool.get(), dt); }
+
+void ScenarioRunner::step(WorkerPool& workers, float dt) {
+    step(&workers, dt);
+}
+
+void ScenarioRunner::step(WorkerPool* workers, float dt) {
+    int numFryers = (int)fryers.size();
+    int numThreads = workers != nullptr ? workers->getNumThreads() : 1;
+    int numChunks = std::min(numFryers, numThreads * 4);
+    readyPerChunk.resize(numChunks);
+
+    auto stepChunk = [&](int chunk) {
+        std::vector<int>& ready = readyPerChunk[chunk];
+        ready.clear();
+        int end = (int)((long)numFryers * (chunk + 1) / numChunks);
+        for (int i = (int)((long)numFryers * chunk / numChunks); i < end;
+             i++) {
+            ScenarioContext& context = *fryers[i];
+            context.fryer.step(dt);
+            if (context.isStepConditionMet()) ready.push_back(i);
+        }
+    };
+    if (workers != nullptr) {
+        workers->parallelFor(numChunks, stepChunk);
+    } else {
+        for (int chunk = 0; chunk < numChunks; chunk++) stepChunk(chunk);
+    }
+    time += dt;
+
+    for (int chunk = 0; chunk < numChunks; chunk++) {
+        for (int i : readyPerChunk[chunk]) resume(*fryers[i]);
+    }
+    while (!timers.empty() && timers.top().wakeTime <= time + TIME_EPSILON) {
+        int i = timers.top().fryer;
+        timers.pop();
+        resume(*fryers[i]);
+    }
+}
+
+void ScenarioRunner::runUntil(double endTime, float dt) {
+    while (time < endTime - TIME_EPSILON) step(dt);
+}
+
+int ScenarioRunner::getNumRunning() const {
+    int count = 0;
+    for (const auto& context : fryers) {
+        if (!context->scenario.isFinished()) count++;
+    }
+    return count;
+}
+
+void ScenarioRunner::suspend(ScenarioContext& context,
+                             ScenarioContext::WaitKind kind, double value,
+                             FryEvent::Type event) {
+    context.waitKind = kind;
+    context.waitValue = value;
+    context.waitEvent = event;
+    if (kind == ScenarioContext::WAIT_TIME) {
+        timers.push({value, context.index});
+    }
+}
+
+void ScenarioRunner::resume(ScenarioContext& context) {
+    if (context.scenario.isFinished()) return;
+    context.waitKind = ScenarioContext::WAIT_NONE;
+    numResumes++;
+    context.scenario.handle.resume();
+}
+
+Scenario timedBaskets(ScenarioContext& s, float shakeAt, float liftAt,
+                      float readyTemperature, float endTime,
+                      std::vector<LiftedBasket>* lifted) {
+    while (s.now() < endTime) {
+        double dropTime = s.now();
+        s.fryer.drop();
+        co_await s.at(dropTime + shakeAt);
+        s.fryer.shake();
+        co_await s.at(dropTime + liftAt);
+        LiftedBasket basket = s.fryer.lift();
+        if (lifted) lifted->push_back(basket);
+        co_await s.oilAtLeast(readyTemperature);
+    }
+}
+
+Scenario doneBaskets(ScenarioContext& s, float shakeAt,
+                     float readyTemperature, float endTime,
+                     std::vector<LiftedBasket>* lifted) {
+    while (s.now() < endTime) {
+        s.fryer.drop();
+        co_await s.after(shakeAt);
+        s.fryer.shake();
+        if (!s.fryer.basketDone) co_await s.event(FryEvent::DONE);
+        LiftedBasket basket = s.fryer.lift();
+        if (lifted) lifted->push_back(basket);
+        co_await s.oilAtLeast(readyTemperature);
+    }
+}
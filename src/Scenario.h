@@ -0,0 +1,185 @@
+#pragma once
+
+#include <coroutine>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "ScriptedFryer.h"
+#include "WorkerPool.h"
+
+class ScenarioContext;
+class ScenarioRunner;
+
+/**
+ * Coroutine handle for a scripted scenario. A scenario is any function
+ * returning Scenario that co_awaits the conditions of its ScenarioContext:
+ *
+ *   Scenario basketCycle(ScenarioContext& s, float liftAfter) {
+ *       while (true) {
+ *           s.fryer.drop();
+ *           co_await s.after(30.0f);
+ *           s.fryer.shake();
+ *           co_await s.after(liftAfter - 30.0f);
+ *           s.fryer.lift();
+ *           co_await s.oilAtLeast(175.0f);
+ *       }
+ *   }
+ *
+ * Arguments are copied into the coroutine frame, so scenarios may take any
+ * parameters; ScenarioRunner::start runs the body up to its first co_await.
+ */
+class Scenario {
+   public:
+    struct promise_type {
+        Scenario get_return_object() {
+            return Scenario(
+                std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();
+    };
+
+    Scenario() {}
+    Scenario(Scenario&& other) noexcept;
+    Scenario& operator=(Scenario&& other) noexcept;
+    Scenario(const Scenario&) = delete;
+    Scenario& operator=(const Scenario&) = delete;
+    ~Scenario();
+
+    bool isFinished() const { return !handle || handle.done(); }
+
+   private:
+    friend class ScenarioRunner;
+
+    explicit Scenario(std::coroutine_handle<promise_type> handle)
+        : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * One scripted fryer and the condition its scenario is suspended on. The
+ * awaitables below are only meant to be co_awaited by that scenario; one
+ * that already holds (a time in the past, oil already past the threshold)
+ * continues without suspending.
+ */
+class ScenarioContext {
+   public:
+    enum WaitKind { WAIT_NONE, WAIT_TIME, WAIT_EVENT, WAIT_OIL_ABOVE,
+                    WAIT_OIL_BELOW };
+
+    struct Wait {
+        bool await_ready() const;
+        void await_suspend(std::coroutine_handle<>) const;
+        void await_resume() const {}
+
+        ScenarioContext* context;
+        WaitKind kind;
+        double value;  // s for WAIT_TIME, °C for the oil thresholds
+        FryEvent::Type event;
+    };
+
+    Wait at(double time);       // absolute simulation time (s)
+    Wait after(float seconds);  // simulation seconds from now
+    Wait event(FryEvent::Type type);
+    Wait oilAtLeast(float temperature);
+    Wait oilAtMost(float temperature);
+
+    double now() const { return fryer.time; }
+
+    ScriptedFryer fryer;
+    int index;
+
+   private:
+    friend class ScenarioRunner;
+
+    ScenarioContext(ScenarioRunner* runner, int index,
+                    const FryerDayConfig& config);
+
+    // Condition checked after every fryer step (events and thresholds)
+    bool isStepConditionMet() const;
+
+    ScenarioRunner* runner;
+    Scenario scenario;
+    WaitKind waitKind;
+    double waitValue;
+    FryEvent::Type waitEvent;
+};
+
+/**
+ * Steps any number of scripted fryers in lockstep on the WorkerPool and
+ * resumes each scenario only when the condition it awaits fires. Time waits
+ * sit in one min-heap keyed by wake time, so a sleeping scenario costs
+ * nothing until it is due; event and threshold waits are a single compare
+ * folded into the fryer's own step. Scenarios resume on the calling thread,
+ * in fryer order, at the end of the step in which their condition fired, so
+ * actions land on step boundaries.
+ */
+class ScenarioRunner {
+   public:
+    enum SharedPool { SHARED_POOL };
+
+    explicit ScenarioRunner(int numThreads = 0);
+    // Owns no threads; stepped only on a shared pool, e.g. from a JobServer
+    // slice (step(dt) and runUntil then run on the calling thread)
+    explicit ScenarioRunner(SharedPool);
+
+    ScenarioContext& addFryer(const FryerDayConfig& config = FryerDayConfig());
+
+    // Takes ownership of the fryer's scenario and runs it to its first wait
+    void start(ScenarioContext& context, Scenario scenario);
+
+    void step(float dt);
+    void runUntil(double endTime, float dt);
+
+    // Steps on a shared pool instead
+    void step(WorkerPool& workers, float dt);
+
+    double getTime() const { return time; }
+    int getNumRunning() const;
+    long getNumResumes() const { return numResumes; }
+
+    std::vector<std::unique_ptr<ScenarioContext>> fryers;
+
+   private:
+    friend class ScenarioContext;
+
+    struct Timer {
+        double wakeTime;
+        int fryer;
+        bool operator>(const Timer& other) const {
+            return wakeTime > other.wakeTime ||
+                   (wakeTime == other.wakeTime && fryer > other.fryer);
+        }
+    };
+
+    void suspend(ScenarioContext& context, ScenarioContext::WaitKind kind,
+                 double value, FryEvent::Type event);
+    void resume(ScenarioContext& context);
+    void step(WorkerPool* workers, float dt);  // Serial if null
+
+    std::unique_ptr<WorkerPool> pool;  // Null for SHARED_POOL
+    double time;  // s; double so long runs of small steps don't drift
+    long numResumes;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>>
+        timers;
+    std::vector<std::vector<int>> readyPerChunk;
+};
+
+/**
+ * Line-cook routine from the request that motivated scenarios: drop, shake
+ * at shakeAt, lift at liftAt (s after the drop), then drop the next basket
+ * as soon as the oil has recovered to readyTemperature. Repeats until
+ * endTime; lifted baskets are appended to lifted if given.
+ */
+Scenario timedBaskets(ScenarioContext& s, float shakeAt, float liftAt,
+                      float readyTemperature, float endTime,
+                      std::vector<LiftedBasket>* lifted = nullptr);
+
+// Same routine, but each basket is lifted at its DONE event
+Scenario doneBaskets(ScenarioContext& s, float shakeAt,
+                     float readyTemperature, float endTime,
+                     std::vector<LiftedBasket>* lifted = nullptr);
@@ -0,0 +1,317 @@
+#include "ScenarioFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "ofMain.h"
+
+namespace {
+
+const char* OUTPUT_NAMES[NUM_SCENARIO_OUTPUTS] = {
+    "oil_temperature", "set_point", "polar_compounds", "fry_temperature",
+    "cookedness",      "moisture",  "crust",           "fries"};
+
+// Guards against a period typo expanding into millions of steps
+const int MAX_TIMELINE_STEPS = 1000000;
+
+bool parseNumber(const std::string& token, float& value) {
+    char* end = nullptr;
+    value = std::strtof(token.c_str(), &end);
+    return !token.empty() && *end == '\0';
+}
+
+bool parseAction(const std::string& token, ScenarioAction::Type& type) {
+    if (token == "drop") {
+        type = ScenarioAction::DROP;
+    } else if (token == "shake") {
+        type = ScenarioAction::SHAKE;
+    } else if (token == "lift") {
+        type = ScenarioAction::LIFT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Same-time steps: actions in file order, then the sample, then the end
+int getOrder(ScenarioAction::Type type) {
+    if (type == ScenarioAction::RECORD) return 1;
+    if (type == ScenarioAction::END) return 2;
+    return 0;
+}
+
+}  // namespace
+
+ScenarioFile::ScenarioFile()
+    : name("scenario"), duration(600.0f), oilTemperature(175.0f) {}
+
+bool ScenarioFile::load(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) file.open(ofToDataPath(path));
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    if (!parse(text.str(), error)) {
+        error = path + ", " + error;
+        return false;
+    }
+    return true;
+}
+
+bool ScenarioFile::parse(const std::string& text, std::string& error) {
+    *this = ScenarioFile();
+
+    // Single-number settings, with the range each must fall in
+    float numFries = basket.numFries;
+    float seed = basket.seed;
+    struct Setting {
+        const char* key;
+        float* value;
+        float min, max;
+    };
+    const Setting settings[] = {
+        {"duration", &duration, 1.0f, 1.0e7f},
+        {"set_point", &fryer.setPoint, 100.0f, 220.0f},
+        {"heater_power", &fryer.heaterPower, 0.0f, 1.0e6f},
+        {"oil_capacity", &fryer.oilHeatCapacity, 1.0f, 1.0e8f},
+        {"oil_temperature", &oilTemperature, 20.0f, 220.0f},
+        {"polar_compounds", &fryer.initialPolarCompounds, 0.0f, 100.0f},
+        {"basket_mass", &fryer.basketMass, 0.01f, 100.0f},
+        {"fries", &numFries, 1.0f, 1000.0f},
+        {"seed", &seed, 0.0f, 1.0e6f},
+    };
+
+    std::vector<ScenarioAction> actions;
+    float recordPeriod = 0.0f;
+    int lineNumber = 0;
+    auto fail = [&](const std::string& message) {
+        error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (words >> token) tokens.push_back(token);
+        if (tokens.empty()) continue;
+
+        // Every argument but names, actions and outputs is a number
+        const std::string& key = tokens[0];
+        std::vector<float> numbers;
+        for (size_t i = 1; i < tokens.size(); i++) {
+            float value;
+            if (parseNumber(tokens[i], value)) numbers.push_back(value);
+        }
+
+        const Setting* setting = nullptr;
+        for (const Setting& candidate : settings) {
+            if (key == candidate.key) setting = &candidate;
+        }
+
+        if (setting != nullptr) {
+            if (tokens.size() != 2 || numbers.size() != 1) {
+                return fail(key + " takes one number");
+            }
+            if (numbers[0] < setting->min || numbers[0] > setting->max) {
+                return fail(key + " is out of range");
+            }
+            *setting->value = numbers[0];
+        } else if (key == "name") {
+            if (tokens.size() != 2) return fail("name takes one word");
+            name = tokens[1];
+        } else if (key == "fry_length" || key == "fry_width") {
+            if (numbers.empty() || numbers.size() != tokens.size() - 1 ||
+                numbers.size() > 2) {
+                return fail(key + " takes a size or a min and max size");
+            }
+            float low = numbers[0];
+            float high = numbers.back();
+            if (low < 1.0f || high < low) return fail(key + " range is bad");
+            if (key == "fry_length") {
+                basket.minLength = low;
+                basket.maxLength = high;
+            } else {
+                basket.minWidth = low;
+                basket.maxWidth = high;
+            }
+        } else if (key == "schedule") {
+            if (tokens.size() != 3 || numbers.size() != 2) {
+                return fail("schedule takes a time and a temperature");
+            }
+            if (numbers[1] < 100.0f || numbers[1] > 220.0f) {
+                return fail("schedule temperature is out of range");
+            }
+            actions.push_back(
+                {numbers[0], ScenarioAction::SET_TEMPERATURE, numbers[1]});
+        } else if (key == "at") {
+            ScenarioAction action = {0.0f, ScenarioAction::DROP, 0.0f};
+            if (tokens.size() != 3 || !parseNumber(tokens[1], action.time) ||
+                !parseAction(tokens[2], action.type)) {
+                return fail("expected: at <s> drop|shake|lift");
+            }
+            actions.push_back(action);
+        } else if (key == "every") {
+            ScenarioAction::Type type;
+            if (tokens.size() != 5 || numbers.size() != 3 ||
+                !parseAction(tokens[4], type)) {
+                return fail("expected: every <s> <from> <to> drop|shake|lift");
+            }
+            float period = numbers[0];
+            float from = numbers[1];
+            float to = numbers[2];
+            if (period <= 0.0f || (to - from) / period > MAX_TIMELINE_STEPS) {
+                return fail("every period is too short");
+            }
+            for (int k = 0; from + k * period <= to + 1e-3f; k++) {
+                actions.push_back({from + k * period, type, 0.0f});
+            }
+        } else if (key == "record") {
+            if (recordPeriod > 0.0f) return fail("record is already set");
+            if (tokens.size() < 4 || tokens[1] != "every" ||
+                !parseNumber(tokens[2], recordPeriod) || recordPeriod <= 0) {
+                return fail("expected: record every <s> <output>...");
+            }
+            for (size_t i = 3; i < tokens.size(); i++) {
+                int found = -1;
+                for (int o = 0; o < NUM_SCENARIO_OUTPUTS; o++) {
+                    if (tokens[i] == OUTPUT_NAMES[o]) found = o;
+                }
+                if (found < 0) {
+                    return fail("unknown output '" + tokens[i] + "'");
+                }
+                outputs.push_back((ScenarioOutput)found);
+            }
+        } else {
+            return fail("unknown statement '" + key + "'");
+        }
+    }
+
+    basket.numFries = (int)numFries;
+    basket.seed = (unsigned int)seed;
+
+    for (const ScenarioAction& action : actions) {
+        if (action.time < 0.0f || action.time > duration) {
+            char message[96];
+            snprintf(message, sizeof(message),
+                     "action at %g s is outside the duration", action.time);
+            error = message;
+            return false;
+        }
+    }
+    if (recordPeriod > 0.0f) {
+        if (duration / recordPeriod > MAX_TIMELINE_STEPS) {
+            error = "record period is too short";
+            return false;
+        }
+        for (int k = 0; k * recordPeriod <= duration + 1e-3f; k++) {
+            actions.push_back(
+                {k * recordPeriod, ScenarioAction::RECORD, 0.0f});
+        }
+    }
+    actions.push_back({duration, ScenarioAction::END, 0.0f});
+
+    std::stable_sort(actions.begin(), actions.end(),
+                     [](const ScenarioAction& a, const ScenarioAction& b) {
+                         if (a.time != b.time) return a.time < b.time;
+                         return getOrder(a.type) < getOrder(b.type);
+                     });
+    timeline = std::move(actions);
+    return true;
+}
+
+void ScenarioFile::prepare(ScriptedFryer& target, int run) const {
+    target.config = fryer;
+    target.oil.temperature = oilTemperature;
+    target.oil.polarCompounds = fryer.initialPolarCompounds;
+    target.contents = basket;
+    target.contents.seed = basket.seed + run;
+}
+
+std::string ScenarioFile::formatHeader() const {
+    std::string header = "run,time";
+    for (ScenarioOutput output : outputs) {
+        header += ",";
+        header += OUTPUT_NAMES[output];
+    }
+    return header + "\n";
+}
+
+std::string ScenarioFile::formatRow(int run, float time,
+                                    const float* values) const {
+    char text[32];
+    snprintf(text, sizeof(text), "%d,%.2f", run, time);
+    std::string row = text;
+    for (ScenarioOutput output : outputs) {
+        snprintf(text, sizeof(text), ",%.4f", values[output]);
+        row += text;
+    }
+    return row + "\n";
+}
+
+const char* ScenarioFile::getOutputName(ScenarioOutput output) {
+    return OUTPUT_NAMES[output];
+}
+
+void sampleScenarioOutputs(const Oil& oil, float setPoint,
+                           const Potato* fries, int numFries, float* values) {
+    std::fill(values, values + NUM_SCENARIO_OUTPUTS, 0.0f);
+    values[OUTPUT_OIL_TEMPERATURE] = oil.temperature;
+    values[OUTPUT_SET_POINT] = setPoint;
+    values[OUTPUT_POLAR_COMPOUNDS] = oil.polarCompounds;
+    values[OUTPUT_FRIES] = numFries;
+    for (int i = 0; i < numFries; i++) {
+        values[OUTPUT_FRY_TEMPERATURE] += fries[i].temperature / numFries;
+        values[OUTPUT_COOKEDNESS] += fries[i].cookedness / numFries;
+        values[OUTPUT_MOISTURE] += fries[i].moistureContent / numFries;
+        values[OUTPUT_CRUST] += fries[i].crustThickness / numFries;
+    }
+}
+
+Scenario playScenarioFile(ScenarioContext& s, const ScenarioFile& file,
+                          std::string* csv,
+                          std::vector<LiftedBasket>* lifted) {
+    double start = s.now();
+    float values[NUM_SCENARIO_OUTPUTS];
+    for (const ScenarioAction& action : file.timeline) {
+        co_await s.at(start + action.time);
+
+        ScriptedFryer& fryer = s.fryer;
+        switch (action.type) {
+            case ScenarioAction::DROP:
+                fryer.drop();
+                break;
+            case ScenarioAction::SHAKE:
+                fryer.shake();
+                break;
+            case ScenarioAction::LIFT: {
+                LiftedBasket basket = fryer.lift();
+                if (lifted) lifted->push_back(basket);
+                break;
+            }
+            case ScenarioAction::SET_TEMPERATURE:
+                fryer.setTemperature(action.value);
+                break;
+            case ScenarioAction::RECORD:
+                if (!csv) break;
+                sampleScenarioOutputs(fryer.oil, fryer.config.setPoint,
+                                      fryer.basket.data(),
+                                      fryer.basketIn ? fryer.basket.size() : 0,
+                                      values);
+                *csv += file.formatRow(s.index, action.time, values);
+                break;
+            case ScenarioAction::END:
+                break;
+        }
+    }
+}
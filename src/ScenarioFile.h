@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Potato.h"
+#include "Scenario.h"
+#include "ScriptedFryer.h"
+
+/**
+ * One step of a compiled scenario. value is the set point (°C) for
+ * SET_TEMPERATURE and unused otherwise.
+ */
+struct ScenarioAction {
+    enum Type { DROP, SHAKE, LIFT, SET_TEMPERATURE, RECORD, END };
+
+    float time;  // s from scenario start
+    Type type;
+    float value;
+};
+
+// Columns a scenario can record; values are basket means where per fry
+enum ScenarioOutput {
+    OUTPUT_OIL_TEMPERATURE,
+    OUTPUT_SET_POINT,
+    OUTPUT_POLAR_COMPOUNDS,
+    OUTPUT_FRY_TEMPERATURE,
+    OUTPUT_COOKEDNESS,
+    OUTPUT_MOISTURE,
+    OUTPUT_CRUST,
+    OUTPUT_FRIES,  // count in the oil
+    NUM_SCENARIO_OUTPUTS
+};
+
+/**
+ * Declarative scenario loaded from a text file such as
+ * bin/data/lunch_rush.scenario. One statement per line, '#' starts a
+ * comment:
+ *
+ *   name <word>                     duration <s>
+ *   set_point <°C>                  heater_power <W>
+ *   oil_capacity <J/°C>             oil_temperature <°C>
+ *   polar_compounds <% TPC>         basket_mass <kg>
+ *   fries <count>                   seed <n>
+ *   fry_length <min> [max]          fry_width <min> [max]
+ *   schedule <s> <°C>               at <s> drop|shake|lift
+ *   every <period> <from> <to> drop|shake|lift
+ *   record every <period> <output>...
+ *
+ * load() compiles everything into a flat timeline sorted by time (schedule
+ * entries become SET_TEMPERATURE, record periods become RECORD steps, and
+ * an END closes it at duration), so runners only walk an index over plain
+ * structs. The same timeline drives ScriptedFryers (play), the viewer and
+ * the job server; the viewer's oil follows the same heat balance as a
+ * ScriptedFryer's while a file plays.
+ */
+class ScenarioFile {
+   public:
+    ScenarioFile();
+
+    // Paths not found as given are looked up in the data folder
+    bool load(const std::string& path, std::string& error);
+    bool parse(const std::string& text, std::string& error);
+
+    // Starting oil and basket for run (fry sizes are seeded per run)
+    void prepare(ScriptedFryer& fryer, int run) const;
+
+    std::string formatHeader() const;
+    std::string formatRow(int run, float time, const float* values) const;
+
+    static const char* getOutputName(ScenarioOutput output);
+
+    std::string name;
+    float duration;  // s
+    FryerDayConfig fryer;
+    float oilTemperature;  // °C at the start
+    BasketContents basket;
+
+    std::vector<ScenarioAction> timeline;
+    std::vector<ScenarioOutput> outputs;
+};
+
+// Fills values[NUM_SCENARIO_OUTPUTS]; fry columns are 0 with no fries
+void sampleScenarioOutputs(const Oil& oil, float setPoint,
+                           const Potato* fries, int numFries, float* values);
+
+/**
+ * Plays file's timeline on a runner fryer from its current time; file must
+ * outlive the scenario. RECORD rows, tagged with the fryer's index, are
+ * appended to csv and lifted baskets to lifted if given.
+ */
+Scenario playScenarioFile(ScenarioContext& s, const ScenarioFile& file,
+                          std::string* csv = nullptr,
+                          std::vector<LiftedBasket>* lifted = nullptr);
@@ -0,0 +1,96 @@
+#include "ScriptedFryer.h"
+
+#include "Rollout.h"
+
+BasketContents::BasketContents()
+    : numFries(1),
+      minLength(120.0f),
+      maxLength(120.0f),
+      minWidth(20.0f),
+      maxWidth(20.0f),
+      seed(1) {}
+
+ofVec2f BasketContents::sampleSize(std::mt19937& rng) const {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float length = minLength + (maxLength - minLength) * unit(rng);
+    float width = minWidth + (maxWidth - minWidth) * unit(rng);
+    return ofVec2f(length, width);
+}
+
+ScriptedFryer::ScriptedFryer(const FryerDayConfig& config)
+    : config(config),
+      oil(HEADLESS_OIL_SURFACE_Y, config.setPoint),
+      time(0.0f),
+      basketIn(false),
+      dropTime(0.0f),
+      basketDone(false),
+      firedEvents(0),
+      basketsLifted(0),
+      basketsDoneAtLift(0),
+      numShakes(0),
+      heaterEnergy(0.0f),
+      rngSeeded(false) {
+    oil.polarCompounds = config.initialPolarCompounds;
+}
+
+void ScriptedFryer::drop() {
+    if (basketIn) return;
+    if (!rngSeeded) {
+        rng.seed(contents.seed);
+        rngSeeded = true;
+    }
+
+    basket.clear();
+    basket.reserve(contents.numFries);
+    for (int i = 0; i < contents.numFries; i++) {
+        ofVec2f size = contents.sampleSize(rng);
+        basket.push_back(makeDroppedFry(HEADLESS_OIL_SURFACE_Y, rng(), size));
+        basket.back().onEvent = [this](const FryEvent& event) {
+            if (++eventCounts[event.type] < (int)basket.size()) return;
+            firedEvents |= 1u << event.type;
+            if (event.type == FryEvent::DONE) basketDone = true;
+        };
+    }
+    std::fill(eventCounts, eventCounts + 3, 0);
+    basketIn = true;
+    basketDone = false;
+    dropTime = time;
+}
+
+void ScriptedFryer::shake() {
+    if (basketIn) numShakes++;
+}
+
+LiftedBasket ScriptedFryer::lift() {
+    LiftedBasket lifted = {};
+    if (!basketIn) return lifted;
+
+    lifted.dropTime = (float)dropTime;
+    lifted.cookTime = (float)(time - dropTime);
+    for (const Potato& fry : basket) {
+        lifted.cookedness += fry.cookedness / basket.size();
+        lifted.moisture += fry.moistureContent / basket.size();
+        lifted.crust += fry.crustThickness / basket.size();
+    }
+    lifted.done = basketDone;
+
+    basketIn = false;
+    basketsLifted++;
+    if (basketDone) basketsDoneAtLift++;
+    return lifted;
+}
+
+void ScriptedFryer::setTemperature(float setPoint) {
+    config.setPoint = setPoint;
+}
+
+void ScriptedFryer::step(float dt) {
+    firedEvents = 0;
+    heaterEnergy += stepFryer(oil, basket.data(),
+                              basketIn ? (int)basket.size() : 0, config, dt);
+    time += dt;
+}
+
+bool ScriptedFryer::hasFired(FryEvent::Type type) const {
+    return (firedEvents >> type) & 1;
+}
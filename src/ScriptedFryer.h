@@ -0,0 +1,85 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "FryerDay.h"
+#include "Oil.h"
+#include "Potato.h"
+
+/**
+ * What goes into a basket: numFries cuts with length and width drawn
+ * uniformly from the given ranges (px, as Potato::size). The default is
+ * the single representative fry used by the other headless runs.
+ */
+struct BasketContents {
+    BasketContents();
+
+    ofVec2f sampleSize(std::mt19937& rng) const;
+
+    int numFries;
+    float minLength, maxLength;
+    float minWidth, maxWidth;
+    unsigned int seed;
+};
+
+/**
+ * Outcome of one basket, taken when it is lifted. Fry state is averaged
+ * over the basket.
+ */
+struct LiftedBasket {
+    float dropTime;  // s, simulation time
+    float cookTime;  // s from drop to lift
+    float cookedness;
+    float moisture;
+    float crust;
+    bool done;  // every fry reached DONE before the lift
+};
+
+/**
+ * Headless fryer driven by a scenario's actions instead of order demand.
+ * The basket's fries share basketMass and are stepped with the oil as in
+ * simulateFryerDay, so dropping a basket sags the oil and the thermostat
+ * recovers it. A fry event counts for the basket once every fry has had
+ * it; those are collected per step in firedEvents for the ScenarioRunner.
+ * The fries' event callbacks point back at the fryer, so fryers are not
+ * copyable.
+ *
+ * Shaking is counted but has no physical effect: fries don't interact in
+ * the headless basket, so there is no clumping for a shake to break up.
+ */
+class ScriptedFryer {
+   public:
+    explicit ScriptedFryer(const FryerDayConfig& config = FryerDayConfig());
+    ScriptedFryer(const ScriptedFryer&) = delete;
+    ScriptedFryer& operator=(const ScriptedFryer&) = delete;
+
+    void drop();
+    void shake();
+    LiftedBasket lift();
+    void setTemperature(float setPoint);
+
+    void step(float dt);
+
+    bool hasFired(FryEvent::Type type) const;
+
+    FryerDayConfig config;
+    BasketContents contents;
+    Oil oil;
+    std::vector<Potato> basket;
+    double time;  // s, simulation time; double so it doesn't drift
+    bool basketIn;
+    double dropTime;
+    bool basketDone;
+    unsigned int firedEvents;  // 1 << FryEvent::Type, last step only
+
+    int basketsLifted;
+    int basketsDoneAtLift;
+    int numShakes;
+    float heaterEnergy;  // J
+
+   private:
+    std::mt19937 rng;  // Fry sizes, seeded from contents.seed at first drop
+    bool rngSeeded;
+    int eventCounts[3];  // Fries that have had each FryEvent::Type
+};
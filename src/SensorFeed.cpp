@@ -0,0 +1,300 @@
+#include "SensorFeed.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "ofMain.h"
+
+namespace {
+
+// File tails have nothing to wait on, so they are re-read at this interval
+const int TAIL_INTERVAL_MS = 2;
+
+bool parseUdpPort(const std::string& source, int& port) {
+    if (source.compare(0, 4, "udp:") != 0) return false;
+    port = std::atoi(source.c_str() + 4);
+    return port > 0 && port < 65536;
+}
+
+std::vector<std::string> splitCsv(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) fields.push_back(field);
+    return fields;
+}
+
+int findColumn(const std::vector<std::string>& header, const char* name) {
+    for (size_t i = 0; i < header.size(); i++) {
+        if (header[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+// Protocol messages from a scenario recording, in time order
+bool convertRecording(std::ifstream& file, const std::string& headerLine,
+                      std::vector<SensorMessage>& messages) {
+    std::vector<std::string> header = splitCsv(headerLine);
+    int runColumn = findColumn(header, "run");
+    int timeColumn = findColumn(header, "time");
+    int oilColumn = findColumn(header, "oil_temperature");
+    int setPointColumn = findColumn(header, "set_point");
+    int friesColumn = findColumn(header, "fries");
+    if (timeColumn < 0 || oilColumn < 0) return false;
+
+    std::string line;
+    std::string firstRun;
+    float lastSetPoint = -1.0f;
+    bool basketIn = false;
+    int basket = 0;
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields = splitCsv(line);
+        if ((int)fields.size() != (int)header.size()) continue;
+        if (runColumn >= 0) {
+            if (firstRun.empty()) firstRun = fields[runColumn];
+            if (fields[runColumn] != firstRun) continue;
+        }
+
+        double time = std::atof(fields[timeColumn].c_str());
+        if (setPointColumn >= 0) {
+            float setPoint = std::atof(fields[setPointColumn].c_str());
+            if (setPoint != lastSetPoint) {
+                messages.push_back(
+                    {SensorMessage::SET_POINT, time, setPoint, 0});
+                lastSetPoint = setPoint;
+            }
+        }
+        messages.push_back({SensorMessage::SAMPLE, time,
+                            (float)std::atof(fields[oilColumn].c_str()), 0});
+        if (friesColumn >= 0) {
+            bool fries = std::atof(fields[friesColumn].c_str()) > 0.0f;
+            if (fries && !basketIn) {
+                messages.push_back({SensorMessage::DROP, time, 0, ++basket});
+            } else if (!fries && basketIn) {
+                messages.push_back({SensorMessage::LIFT, time, 0, basket});
+            }
+            basketIn = fries;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool SensorMessage::parse(const std::string& line, SensorMessage& message) {
+    std::istringstream words(line);
+    std::string time, first, second, extra;
+    if (!(words >> time >> first) || (words >> second && words >> extra)) {
+        return false;
+    }
+
+    char* end = nullptr;
+    message.time = std::strtod(time.c_str(), &end);
+    if (*end != '\0') return false;
+
+    message.value = 0.0f;
+    message.basket = 0;
+    if (second.empty()) {
+        message.type = SAMPLE;
+        message.value = std::strtof(first.c_str(), &end);
+        return *end == '\0';
+    }
+    if (first == "setpoint") {
+        message.type = SET_POINT;
+        message.value = std::strtof(second.c_str(), &end);
+        return *end == '\0';
+    }
+    if (first == "drop" || first == "lift") {
+        message.type = first == "drop" ? DROP : LIFT;
+        message.basket = (int)std::strtol(second.c_str(), &end, 10);
+        return *end == '\0';
+    }
+    return false;
+}
+
+std::string SensorMessage::format() const {
+    char text[64];
+    switch (type) {
+        case SAMPLE:
+            snprintf(text, sizeof(text), "%.3f %.3f\n", time, value);
+            break;
+        case SET_POINT:
+            snprintf(text, sizeof(text), "%.3f setpoint %.2f\n", time, value);
+            break;
+        case DROP:
+        case LIFT:
+            snprintf(text, sizeof(text), "%.3f %s %d\n", time,
+                     type == DROP ? "drop" : "lift", basket);
+            break;
+    }
+    return text;
+}
+
+SensorFeed::SensorFeed() : numMalformed(0), fd(-1) {}
+
+SensorFeed::~SensorFeed() { close(); }
+
+bool SensorFeed::open(const std::string& source) {
+    close();
+    int port;
+    if (!parseUdpPort(source, port)) {
+        // Opened by poll as soon as it exists
+        path = source;
+        return true;
+    }
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || bind(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        ofLogError("SensorFeed") << "cannot listen on " << source;
+        close();
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+void SensorFeed::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    path.clear();
+    partial.clear();
+}
+
+int SensorFeed::poll(int timeoutMs, std::vector<SensorMessage>& messages) {
+    int added = 0;
+    char buffer[65536];
+
+    if (path.empty()) {
+        if (fd < 0) return 0;
+        pollfd waitFd = {fd, POLLIN, 0};
+        if (::poll(&waitFd, 1, timeoutMs) <= 0) return 0;
+        ssize_t received;
+        while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            // A datagram holds whole lines; a missing final newline is fine
+            appendLines(buffer, received, messages, added);
+            appendLines("\n", 1, messages, added);
+        }
+        return added;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        if (fd < 0) fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK);
+        if (fd >= 0) {
+            ssize_t received;
+            while ((received = read(fd, buffer, sizeof(buffer))) > 0) {
+                appendLines(buffer, received, messages, added);
+            }
+        }
+        if (added > 0 || std::chrono::steady_clock::now() >= deadline) {
+            return added;
+        }
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(TAIL_INTERVAL_MS));
+    }
+}
+
+void SensorFeed::appendLines(const char* data, size_t size,
+                             std::vector<SensorMessage>& messages,
+                             int& added) {
+    partial.append(data, size);
+    size_t start = 0, end;
+    while ((end = partial.find('\n', start)) != std::string::npos) {
+        std::string line = partial.substr(start, end - start);
+        start = end + 1;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        SensorMessage message;
+        if (SensorMessage::parse(line, message)) {
+            messages.push_back(message);
+            added++;
+        } else {
+            numMalformed++;
+        }
+    }
+    partial.erase(0, start);
+}
+
+bool replaySensorLog(const std::string& logPath, const std::string& target,
+                     float speed) {
+    std::ifstream file(logPath);
+    if (!file) {
+        ofLogError("SensorFeed") << "cannot open " << logPath;
+        return false;
+    }
+
+    std::vector<SensorMessage> messages;
+    std::string line;
+    if (std::getline(file, line) && line.find(',') != std::string::npos) {
+        if (!convertRecording(file, line, messages)) {
+            ofLogError("SensorFeed") << logPath << " has no time and "
+                                     << "oil_temperature columns";
+            return false;
+        }
+    } else {
+        do {
+            SensorMessage message;
+            if (SensorMessage::parse(line, message)) {
+                messages.push_back(message);
+            }
+        } while (std::getline(file, line));
+    }
+    if (messages.empty()) return true;
+
+    int port;
+    bool udp = parseUdpPort(target, port);
+    int out = -1;
+    sockaddr_in address = {};
+    if (udp) {
+        out = socket(AF_INET, SOCK_DGRAM, 0);
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    } else {
+        out = ::open(target.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    }
+    if (out < 0) {
+        ofLogError("SensorFeed") << "cannot open " << target;
+        return false;
+    }
+
+    // Messages sharing a timestamp go out together, on the log's schedule
+    auto start = std::chrono::steady_clock::now();
+    double firstTime = messages[0].time;
+    for (size_t i = 0; i < messages.size();) {
+        double time = messages[i].time;
+        std::string lines;
+        for (; i < messages.size() && messages[i].time == time; i++) {
+            lines += messages[i].format();
+        }
+        std::this_thread::sleep_until(
+            start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::duration<double>((time - firstTime) /
+                                                     speed)));
+        if (udp) {
+            sendto(out, lines.data(), lines.size(), 0, (sockaddr*)&address,
+                   sizeof(address));
+        } else if (write(out, lines.data(), lines.size()) < 0) {
+            break;
+        }
+    }
+    ::close(out);
+    return true;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * One line of the fryer sensor protocol. Times are seconds on the sensor's
+ * own timeline:
+ *
+ *   <t> <°C>             thermocouple sample of the oil
+ *   <t> setpoint <°C>    thermostat set point changed
+ *   <t> drop <basket>    basket lowered into the oil
+ *   <t> lift <basket>    basket lifted out
+ */
+struct SensorMessage {
+    enum Type { SAMPLE, SET_POINT, DROP, LIFT };
+
+    Type type;
+    double time;  // double so a feed running for hours keeps its resolution
+    float value;  // °C for SAMPLE and SET_POINT
+    int basket;   // DROP and LIFT
+
+    static bool parse(const std::string& line, SensorMessage& message);
+    std::string format() const;
+};
+
+/**
+ * Non-blocking reader of sensor messages from either a file being appended
+ * to ("tail -f", also a named pipe) or datagrams on a loopback UDP port,
+ * one or more lines per datagram. A file that doesn't exist yet is opened
+ * once it appears and is read from its start.
+ */
+class SensorFeed {
+   public:
+    SensorFeed();
+    ~SensorFeed();
+
+    // "udp:<port>" or a file path
+    bool open(const std::string& source);
+    void close();
+
+    // Waits up to timeoutMs for input and appends every complete message;
+    // returns how many were added. Malformed lines are skipped and counted.
+    int poll(int timeoutMs, std::vector<SensorMessage>& messages);
+
+    int numMalformed;
+
+   private:
+    void appendLines(const char* data, size_t size,
+                     std::vector<SensorMessage>& messages, int& added);
+
+    std::string path;  // Empty for UDP
+    int fd;
+    std::string partial;
+};
+
+/**
+ * Stand-in for a live thermocouple: replays a recorded log to a SensorFeed
+ * source ("udp:<port>" or a file to append to), paced at speed times real
+ * time. The log is either protocol lines or a scenario recording (CSV with
+ * time, oil_temperature and optionally set_point and fries columns; the
+ * first run only), where changes in the fry count become drops and lifts.
+ */
+bool replaySensorLog(const std::string& logPath, const std::string& target,
+                     float speed);
@@ -0,0 +1,323 @@
+#include "SimulationJob.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "RecipeSearch.h"
+#include "Rollout.h"
+#include "ScenarioFile.h"
+#include "ofMain.h"
+
+namespace {
+
+const float ROLLOUT_STEP = 0.25f;
+const float MAX_ROLLOUT_TIME = 600.0f;
+
+float getNumber(const SimulationJob::Request& request, const std::string& key,
+                float fallback) {
+    auto it = request.find(key);
+    return it == request.end() ? fallback : std::atof(it->second.c_str());
+}
+
+// Relative, and no ".." component to climb out of the data folder with
+bool isDataPath(const std::string& path) {
+    if (path.empty() || path[0] == '/') return false;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = std::min(path.find('/', start), path.size());
+        if (path.compare(start, end - start, "..") == 0) return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+std::string formatRecipe(const Recipe& recipe) {
+    char text[256];
+    snprintf(text, sizeof(text),
+             "{\"dropTemperature\":%.1f,\"finishTemperature\":%.1f,"
+             "\"switchTime\":%.1f,\"fryTime\":%.1f}",
+             recipe.dropTemperature, recipe.finishTemperature,
+             recipe.switchTime, recipe.fryTime);
+    return text;
+}
+
+float getSeconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() -
+                                        start)
+        .count();
+}
+
+class RolloutJob : public SimulationJob {
+   public:
+    explicit RolloutJob(float temperature)
+        : temperature(temperature), done(false) {}
+
+    bool runSlice(WorkerPool&, float) override {
+        TemperatureSchedule schedule;
+        schedule.switchTimes = {0.0f};
+        schedule.targets = {temperature};
+        result = rolloutFry(makeDroppedFry(HEADLESS_OIL_SURFACE_Y, 1),
+                            Oil(HEADLESS_OIL_SURFACE_Y, temperature),
+                            schedule, HEADLESS_BASKET_BOTTOM_Y,
+                            MAX_ROLLOUT_TIME, ROLLOUT_STEP);
+        done = true;
+        return true;
+    }
+
+    float getProgress() const override { return done ? 1.0f : 0.0f; }
+
+    std::string getResult() const override {
+        char text[256];
+        snprintf(text, sizeof(text),
+                 "{\"temperature\":%.1f,\"doneTime\":%.2f,"
+                 "\"moistureAtDone\":%.4f,\"crustAtDone\":%.4f,"
+                 "\"thermalDose\":%.1f}",
+                 temperature, result.doneTime, result.moistureAtDone,
+                 result.crustAtDone, result.thermalDose);
+        return text;
+    }
+
+   private:
+    float temperature;
+    bool done;
+    RolloutResult result;
+};
+
+class SweepJob : public SimulationJob {
+   public:
+    explicit SweepJob(int resolution)
+        : resolution(resolution),
+          total(resolution * resolution * resolution),
+          next(0),
+          batchSize(64),
+          numDone(0) {
+        fastest.doneTime = -1;
+    }
+
+    bool runSlice(WorkerPool& pool, float targetSeconds) override {
+        auto start = std::chrono::steady_clock::now();
+        int count = std::min(batchSize, total - next);
+        std::vector<Recipe> recipes(count);
+        std::vector<RolloutResult> results(count);
+        for (int i = 0; i < count; i++) recipes[i] = getRecipe(next + i);
+
+        Potato fry = makeDroppedFry(HEADLESS_OIL_SURFACE_Y, 1);
+        pool.parallelFor(count, [&](int i) {
+            results[i] = rolloutFry(
+                fry, Oil(HEADLESS_OIL_SURFACE_Y, recipes[i].dropTemperature),
+                recipes[i].getSchedule(), HEADLESS_BASKET_BOTTOM_Y,
+                recipes[i].fryTime, ROLLOUT_STEP);
+        });
+
+        for (int i = 0; i < count; i++) {
+            if (results[i].doneTime < 0) continue;
+            numDone++;
+            if (fastest.doneTime < 0 ||
+                results[i].doneTime < fastest.doneTime) {
+                fastest = results[i];
+                fastestRecipe = recipes[i];
+            }
+        }
+        next += count;
+
+        // Size the next batch so a slice lands near the target
+        float seconds = std::max(1e-4f, getSeconds(start));
+        batchSize = ofClamp(batchSize * targetSeconds / seconds,
+                            pool.getNumThreads(), 1 << 20);
+        return next >= total;
+    }
+
+    float getProgress() const override { return (float)next / total; }
+
+    std::string getResult() const override {
+        char text[512];
+        snprintf(text, sizeof(text),
+                 "{\"evaluated\":%d,\"done\":%d,\"fastestDoneTime\":%.2f,"
+                 "\"fastest\":%s}",
+                 next, numDone, fastest.doneTime,
+                 numDone > 0 ? formatRecipe(fastestRecipe).c_str() : "null");
+        return text;
+    }
+
+   private:
+    // Grid point i: drop temperature slowest, switch time fastest
+    Recipe getRecipe(int i) const {
+        float scale = 1.0f / std::max(1, resolution - 1);
+        int s = i % resolution;
+        int f = (i / resolution) % resolution;
+        int d = i / (resolution * resolution);
+
+        Recipe recipe;
+        recipe.dropTemperature = ofLerp(160.0f, 190.0f, d * scale);
+        recipe.finishTemperature = ofLerp(160.0f, 190.0f, f * scale);
+        recipe.fryTime = 240.0f;
+        recipe.switchTime = ofLerp(0.0f, recipe.fryTime, s * scale);
+        return recipe;
+    }
+
+    int resolution;
+    int total;
+    int next;
+    int batchSize;
+    int numDone;
+    RolloutResult fastest;
+    Recipe fastestRecipe;
+};
+
+class RecipeSearchJob : public SimulationJob {
+   public:
+    RecipeSearchJob(int population, int generations, unsigned int seed)
+        : search(1, seed), batchSize(64) {
+        search.populationSize = population;
+        search.numGenerations = generations;
+        search.start();
+    }
+
+    bool runSlice(WorkerPool& pool, float targetSeconds) override {
+        auto start = std::chrono::steady_clock::now();
+        bool searching = search.runBatch(pool, batchSize);
+
+        // Size the next batch so a slice lands near the target
+        float seconds = std::max(1e-4f, getSeconds(start));
+        batchSize = ofClamp(batchSize * targetSeconds / seconds,
+                            pool.getNumThreads(), 1 << 20);
+        return !searching;
+    }
+
+    float getProgress() const override { return search.getProgress(); }
+
+    std::string getResult() const override {
+        std::string best =
+            search.best.empty() ? "null" : formatRecipe(search.best[0].recipe);
+        return "{\"feasible\":" + std::to_string(search.best.size()) +
+               ",\"paretoSize\":" + std::to_string(search.pareto.size()) +
+               ",\"best\":" + best + "}";
+    }
+
+   private:
+    RecipeSearch search;  // Single-threaded; slices run on the shared pool
+    int batchSize;
+};
+
+class ScenarioJob : public SimulationJob {
+   public:
+    ScenarioJob(std::unique_ptr<ScenarioFile> file, int runs,
+                const std::string& output)
+        : file(std::move(file)),
+          runner(ScenarioRunner::SHARED_POOL),
+          output(output),
+          csv(runs) {
+        for (int run = 0; run < runs; run++) {
+            ScenarioContext& fryer = runner.addFryer(this->file->fryer);
+            this->file->prepare(fryer.fryer, run);
+            runner.start(fryer,
+                         playScenarioFile(fryer, *this->file,
+                                          output.empty() ? nullptr : &csv[run],
+                                          &lifted));
+        }
+    }
+
+    bool runSlice(WorkerPool& pool, float targetSeconds) override {
+        auto start = std::chrono::steady_clock::now();
+        while (runner.getTime() < file->duration - 1e-9 &&
+               getSeconds(start) < targetSeconds) {
+            runner.step(pool, ROLLOUT_STEP);
+        }
+        if (runner.getTime() < file->duration - 1e-9) return false;
+
+        if (!output.empty()) {
+            FILE* out = fopen(ofToDataPath(output).c_str(), "w");
+            bool written = out != nullptr;
+            if (written) {
+                fputs(file->formatHeader().c_str(), out);
+                for (const std::string& rows : csv) {
+                    fwrite(rows.data(), 1, rows.size(), out);
+                }
+                written = fclose(out) == 0;
+            }
+            if (!written) error = "cannot write " + output;
+        }
+        return true;
+    }
+
+    float getProgress() const override {
+        return std::min(1.0f, (float)(runner.getTime() / file->duration));
+    }
+
+    std::string getResult() const override {
+        int numDone = 0;
+        float cookedness = 0.0f;
+        for (const LiftedBasket& basket : lifted) {
+            numDone += basket.done;
+            cookedness += basket.cookedness / lifted.size();
+        }
+        char text[256];
+        snprintf(text, sizeof(text),
+                 "{\"name\":\"%s\",\"runs\":%zu,\"lifted\":%zu,"
+                 "\"done\":%d,\"meanCookedness\":%.4f,",
+                 file->name.c_str(), runner.fryers.size(), lifted.size(),
+                 numDone, cookedness);
+        std::string result = text;
+        result += output.empty() ? "\"output\":null}"
+                                 : "\"output\":\"" + output + "\"}";
+        return result;
+    }
+
+   private:
+    std::unique_ptr<ScenarioFile> file;
+    ScenarioRunner runner;  // Slices run on the shared pool
+    std::string output;
+    std::vector<std::string> csv;  // Rows of each run
+    std::vector<LiftedBasket> lifted;
+};
+
+}  // namespace
+
+std::unique_ptr<SimulationJob> SimulationJob::create(const Request& request,
+                                                     std::string& error) {
+    auto it = request.find("type");
+    std::string jobType = it == request.end() ? "" : it->second;
+
+    std::unique_ptr<SimulationJob> job;
+    if (jobType == "rollout") {
+        float temperature =
+            ofClamp(getNumber(request, "temperature", 175.0f), 140.0f, 200.0f);
+        job.reset(new RolloutJob(temperature));
+    } else if (jobType == "sweep") {
+        int resolution = ofClamp(getNumber(request, "resolution", 24), 2, 200);
+        job.reset(new SweepJob(resolution));
+    } else if (jobType == "recipes") {
+        int population =
+            ofClamp(getNumber(request, "population", 2000), 10, 100000);
+        int generations =
+            ofClamp(getNumber(request, "generations", 40), 1, 1000);
+        unsigned int seed = (unsigned int)getNumber(request, "seed", 1);
+        job.reset(new RecipeSearchJob(population, generations, seed));
+    } else if (jobType == "scenario") {
+        // Clients only reach files in the data folder
+        auto it = request.find("file");
+        if (it == request.end()) {
+            error = "scenario job needs a file";
+            return nullptr;
+        }
+        auto output = request.find("output");
+        std::string outputPath = output == request.end() ? "" : output->second;
+        if (!isDataPath(it->second) ||
+            (!outputPath.empty() && !isDataPath(outputPath))) {
+            error = "scenario paths must be relative, without '..'";
+            return nullptr;
+        }
+        std::unique_ptr<ScenarioFile> file(new ScenarioFile());
+        if (!file->load(ofToDataPath(it->second), error)) return nullptr;
+        int runs = ofClamp(getNumber(request, "runs", 1), 1, 100000);
+        job.reset(new ScenarioJob(std::move(file), runs, outputPath));
+    } else {
+        error = "unknown job type '" + jobType + "'";
+        return nullptr;
+    }
+    job->type = jobType;
+    return job;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "WorkerPool.h"
+
+/**
+ * Unit of work for the JobServer. A job runs as a series of slices on the
+ * shared pool; each slice ends at a checkpoint where the server may switch
+ * to a more urgent job or drop a cancelled one, so slices should stay well
+ * under 100 ms.
+ *
+ * Job types (request field "type"):
+ *   rollout: one fry at "temperature" until DONE (interactive)
+ *   sweep:   grid of two-stage recipes, "resolution" points per axis over
+ *            drop and finish temperature and switch time, each run to DONE;
+ *            reports the fastest
+ *   recipes: RecipeSearch with "population" and "generations", scored in
+ *            batches sized to the slice
+ *   scenario: scenario "file" played on "runs" fryers, recorded outputs
+ *            written to "output" (CSV) if given; both paths are relative
+ *            to the data folder and may not be absolute or contain ".."
+ */
+class SimulationJob {
+   public:
+    using Request = std::map<std::string, std::string>;
+
+    // Builds the job for a request, or returns nullptr and sets error
+    static std::unique_ptr<SimulationJob> create(const Request& request,
+                                                 std::string& error);
+
+    virtual ~SimulationJob() {}
+
+    // Runs one slice of about targetSeconds; true once the job is complete
+    virtual bool runSlice(WorkerPool& pool, float targetSeconds) = 0;
+
+    virtual float getProgress() const = 0;      // [0, 1]
+    virtual std::string getResult() const = 0;  // JSON object
+
+    std::string type;
+    std::string error;  // Set by a job that finished but failed
+};
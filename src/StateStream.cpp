@@ -0,0 +1,284 @@
+#include "StateStream.h"
+
+#include <cmath>
+
+namespace {
+
+const uint8_t FLAG_KEYFRAME = 1;
+
+int32_t quantizeValue(float value, float scale) {
+    return (int32_t)std::lround(value * scale);
+}
+
+void writeVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+void writeSigned(std::string& out, int64_t value) {
+    writeVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+// Bounds-checked reader; any overrun latches ok to false
+struct Reader {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    bool ok;
+
+    uint8_t readByte() {
+        if (offset >= size) {
+            ok = false;
+            return 0;
+        }
+        return data[offset++];
+    }
+
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = readByte();
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t readSigned() {
+        uint64_t value = readVarint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+};
+
+// Writes the fields of current that differ from base, behind their mask
+template <int N>
+void writeFields(std::string& out, const int32_t* current,
+                 const int32_t* base) {
+    static_assert(N <= 8, "field mask is one byte");
+    uint8_t mask = 0;
+    for (int f = 0; f < N; f++) {
+        if (current[f] != base[f]) mask |= 1 << f;
+    }
+    out.push_back((char)mask);
+    for (int f = 0; f < N; f++) {
+        if (mask & (1 << f)) writeSigned(out, (int64_t)current[f] - base[f]);
+    }
+}
+
+template <int N>
+void readFields(Reader& in, int32_t* current, const int32_t* base) {
+    uint8_t mask = in.readByte();
+    for (int f = 0; f < N; f++) {
+        current[f] = base[f];
+        if (mask & (1 << f)) current[f] += (int32_t)in.readSigned();
+    }
+}
+
+const int32_t ZERO_FIELDS[8] = {};
+
+}  // namespace
+
+float StreamState::getFryScale(int field) {
+    switch (field) {
+        case Fry::X:
+        case Fry::Y:
+        case Fry::WIDTH:
+        case Fry::HEIGHT:
+            return POSITION_SCALE;
+        case Fry::TEMPERATURE:
+            return TEMPERATURE_SCALE;
+        default:
+            return FRACTION_SCALE;
+    }
+}
+
+float StreamState::getBubbleScale(int field) {
+    switch (field) {
+        case Bubble::X:
+        case Bubble::Y:
+            return POSITION_SCALE;
+        case Bubble::SIZE:
+            return SIZE_SCALE;
+        default:
+            return 1.0f;
+    }
+}
+
+StreamState StreamState::quantize(const FrameSnapshot& frame,
+                                  uint64_t number) {
+    StreamState state;
+    state.frame = number;
+    state.simTimeMs = (uint32_t)std::lround(frame.simTime * 1000.0f);
+    state.oilTemperature = quantizeValue(frame.oilTemperature, OIL_SCALE);
+    state.targetTemperature =
+        quantizeValue(frame.targetTemperature, OIL_SCALE);
+    state.polarCompounds = quantizeValue(frame.polarCompounds, OIL_SCALE);
+
+    state.fries.resize(frame.numFries);
+    for (int i = 0; i < frame.numFries; i++) {
+        const float real[Fry::NUM_FIELDS] = {
+            frame.fryX[i],           frame.fryY[i],
+            frame.fryWidth[i],       frame.fryHeight[i],
+            frame.fryTemperature[i], frame.fryMoisture[i],
+            frame.fryCookedness[i],  frame.fryCrust[i]};
+        for (int f = 0; f < Fry::NUM_FIELDS; f++) {
+            state.fries[i].value[f] = quantizeValue(real[f], getFryScale(f));
+        }
+    }
+
+    state.bubbles.resize(frame.numBubbles);
+    for (int i = 0; i < frame.numBubbles; i++) {
+        Bubble& bubble = state.bubbles[i];
+        bubble.id = frame.bubbleId[i];
+        bubble.value[Bubble::X] =
+            quantizeValue(frame.bubbleX[i], POSITION_SCALE);
+        bubble.value[Bubble::Y] =
+            quantizeValue(frame.bubbleY[i], POSITION_SCALE);
+        bubble.value[Bubble::SIZE] =
+            quantizeValue(frame.bubbleSize[i], SIZE_SCALE);
+        bubble.value[Bubble::KIND] =
+            frame.bubbleType[i] * 2 + frame.bubbleSurfaced[i];
+    }
+    return state;
+}
+
+StateEncoder::StateEncoder(int keyframeInterval)
+    : keyframeInterval(keyframeInterval), sinceKeyframe(0) {
+    reset();
+}
+
+void StateEncoder::reset() {
+    previous.fries.clear();
+    previous.bubbles.clear();
+    sinceKeyframe = keyframeInterval;
+}
+
+const std::string& StateEncoder::encode(const FrameSnapshot& frame,
+                                        uint64_t number, bool& keyframe) {
+    StreamState current = StreamState::quantize(frame, number);
+
+    keyframe = sinceKeyframe >= keyframeInterval;
+    if (keyframe) {
+        previous.fries.clear();
+        previous.bubbles.clear();
+        sinceKeyframe = 0;
+    }
+    sinceKeyframe++;
+
+    message.clear();
+    message.push_back((char)(keyframe ? FLAG_KEYFRAME : 0));
+    writeVarint(message, current.frame);
+    writeVarint(message, current.simTimeMs);
+    writeSigned(message, current.oilTemperature);
+    writeSigned(message, current.targetTemperature);
+    writeSigned(message, current.polarCompounds);
+
+    writeVarint(message, current.fries.size());
+    for (size_t i = 0; i < current.fries.size(); i++) {
+        const int32_t* base = i < previous.fries.size()
+                                  ? previous.fries[i].value
+                                  : ZERO_FIELDS;
+        writeFields<StreamState::Fry::NUM_FIELDS>(
+            message, current.fries[i].value, base);
+    }
+
+    writeVarint(message, current.bubbles.size());
+    size_t match = 0;
+    uint32_t lastId = 0;
+    for (const auto& bubble : current.bubbles) {
+        writeSigned(message, (int64_t)bubble.id - lastId);
+        lastId = bubble.id;
+
+        while (match < previous.bubbles.size() &&
+               previous.bubbles[match].id < bubble.id) {
+            match++;
+        }
+        const int32_t* base = ZERO_FIELDS;
+        if (match < previous.bubbles.size() &&
+            previous.bubbles[match].id == bubble.id) {
+            base = previous.bubbles[match++].value;
+        }
+        writeFields<StreamState::Bubble::NUM_FIELDS>(message, bubble.value,
+                                                     base);
+    }
+
+    previous = std::move(current);
+    return message;
+}
+
+StateDecoder::StateDecoder() : synced(false) {
+    state.frame = 0;
+    state.simTimeMs = 0;
+    state.oilTemperature = 0;
+    state.targetTemperature = 0;
+    state.polarCompounds = 0;
+}
+
+bool StateDecoder::decode(const uint8_t* data, size_t size) {
+    Reader in = {data, size, 0, true};
+    bool keyframe = in.readByte() & FLAG_KEYFRAME;
+    uint64_t frame = in.readVarint();
+    if (!in.ok) return false;
+
+    // A delta is only meaningful on top of the frame it was coded against
+    if (!keyframe && (!synced || frame != state.frame + 1)) {
+        synced = false;
+        return false;
+    }
+
+    StreamState next;
+    next.frame = frame;
+    next.simTimeMs = (uint32_t)in.readVarint();
+    next.oilTemperature = (int32_t)in.readSigned();
+    next.targetTemperature = (int32_t)in.readSigned();
+    next.polarCompounds = (int32_t)in.readSigned();
+
+    static const std::vector<StreamState::Fry> noFries;
+    static const std::vector<StreamState::Bubble> noBubbles;
+    const auto& previousFries = keyframe ? noFries : state.fries;
+    const auto& previousBubbles = keyframe ? noBubbles : state.bubbles;
+
+    uint64_t numFries = in.readVarint();
+    if (!in.ok || numFries > size) return false;
+    next.fries.resize(numFries);
+    for (size_t i = 0; i < numFries; i++) {
+        const int32_t* base = i < previousFries.size()
+                                  ? previousFries[i].value
+                                  : ZERO_FIELDS;
+        readFields<StreamState::Fry::NUM_FIELDS>(in, next.fries[i].value,
+                                                 base);
+    }
+
+    uint64_t numBubbles = in.readVarint();
+    if (!in.ok || numBubbles > size) return false;
+    next.bubbles.resize(numBubbles);
+    size_t match = 0;
+    uint32_t lastId = 0;
+    for (auto& bubble : next.bubbles) {
+        bubble.id = (uint32_t)(lastId + in.readSigned());
+        lastId = bubble.id;
+
+        while (match < previousBubbles.size() &&
+               previousBubbles[match].id < bubble.id) {
+            match++;
+        }
+        const int32_t* base = ZERO_FIELDS;
+        if (match < previousBubbles.size() &&
+            previousBubbles[match].id == bubble.id) {
+            base = previousBubbles[match++].value;
+        }
+        readFields<StreamState::Bubble::NUM_FIELDS>(in, bubble.value, base);
+    }
+
+    if (!in.ok) {
+        synced = false;
+        return false;
+    }
+    state = std::move(next);
+    synced = true;
+    return true;
+}
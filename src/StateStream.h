@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FrameRing.h"
+
+// Publishers stream to a browser dashboard on this port + fryer
+const int DASHBOARD_BASE_PORT = 8701;
+
+/**
+ * Fry and bubble state as carried by the dashboard stream: fixed-point
+ * integers, value = round(real * scale). Quantization error is at most half
+ * a step (1/16 px for positions).
+ */
+struct StreamState {
+    static constexpr float POSITION_SCALE = 8.0f;      // 1/8 px
+    static constexpr float SIZE_SCALE = 16.0f;         // 1/16 px
+    static constexpr float TEMPERATURE_SCALE = 20.0f;  // 0.05 °C
+    static constexpr float FRACTION_SCALE = 1000.0f;   // 0.1 %
+    static constexpr float OIL_SCALE = 100.0f;         // 0.01 °C, 0.01 % TPC
+
+    struct Fry {
+        enum Field {
+            X,
+            Y,
+            WIDTH,
+            HEIGHT,
+            TEMPERATURE,
+            MOISTURE,
+            COOKEDNESS,
+            CRUST,
+            NUM_FIELDS
+        };
+        int32_t value[NUM_FIELDS];
+    };
+
+    // KIND is bubbleType * 2 + surfaced
+    struct Bubble {
+        enum Field { X, Y, SIZE, KIND, NUM_FIELDS };
+        uint32_t id;
+        int32_t value[NUM_FIELDS];
+    };
+
+    static float getFryScale(int field);
+    static float getBubbleScale(int field);
+    static StreamState quantize(const FrameSnapshot& frame, uint64_t number);
+
+    uint64_t frame;
+    uint32_t simTimeMs;
+    int32_t oilTemperature;
+    int32_t targetTemperature;
+    int32_t polarCompounds;
+    std::vector<Fry> fries;
+    std::vector<Bubble> bubbles;
+};
+
+/**
+ * Encodes successive frames as compact binary messages. Each fry and bubble
+ * carries a bit mask of the fields that changed since the previous message
+ * and only those fields, as zigzag varint deltas. Fries are matched by
+ * index and bubbles by id (merge join; ids increase in list order), and an
+ * unmatched entity is coded against zero. Every keyframeInterval-th message
+ * is coded entirely against zero, so a client joining or resyncing needs
+ * nothing older than it.
+ *
+ * Message layout (varints are LEB128, signed values zigzag):
+ *   u8 flags (bit 0: keyframe), frame, simTimeMs, oil, target, TPC,
+ *   fry count, per fry { u8 mask, changed field deltas },
+ *   bubble count, per bubble { id delta, u8 mask, changed field deltas }
+ */
+class StateEncoder {
+   public:
+    explicit StateEncoder(int keyframeInterval = 60);
+
+    // Returns the message for this frame; valid until the next call
+    const std::string& encode(const FrameSnapshot& frame, uint64_t number,
+                              bool& keyframe);
+
+    // Forget the reference state; the next message is a keyframe
+    void reset();
+
+    int keyframeInterval;
+
+   private:
+    StreamState previous;
+    std::string message;
+    int sinceKeyframe;
+};
+
+/**
+ * Rebuilds StreamState from StateEncoder messages. Delta messages are only
+ * accepted directly after the frame they were coded against; after a gap
+ * the decoder waits for the next keyframe.
+ */
+class StateDecoder {
+   public:
+    StateDecoder();
+
+    // False if the message is malformed or can't be applied yet
+    bool decode(const uint8_t* data, size_t size);
+
+    StreamState state;
+    bool synced;
+};
@@ -0,0 +1,168 @@
+#include "StreamCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+#include "FrameRing.h"
+#include "StateStream.h"
+#include "WebSocketClient.h"
+
+namespace {
+
+void track(float& maxError, float decoded, float truth) {
+    maxError = std::max(maxError, std::fabs(decoded - truth));
+}
+
+}  // namespace
+
+StreamCheckReport checkStateStream(int fryer, int numFrames) {
+    StreamCheckReport report = {};
+
+    FrameRing ring;
+    WebSocketClient client;
+    if (!ring.attach(FrameRing::getName(fryer)) ||
+        !client.connect("127.0.0.1", DASHBOARD_BASE_PORT + fryer)) {
+        return report;
+    }
+
+    StateDecoder decoder;
+    auto truth = std::make_unique<FrameSnapshot>();
+    std::string message;
+    size_t totalBytes = 0, keyframeBytes = 0, deltaBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (report.framesDecoded < numFrames && client.receive(message, 2000)) {
+        totalBytes += message.size();
+        if (!decoder.decode((const uint8_t*)message.data(), message.size())) {
+            continue;  // Waiting for a keyframe
+        }
+        report.framesDecoded++;
+        if (message[0] & 1) {
+            report.keyframes++;
+            keyframeBytes += message.size();
+        } else {
+            deltaBytes += message.size();
+        }
+
+        // The ring keeps the last few frames; the stream is rarely behind
+        const StreamState& state = decoder.state;
+        if (!ring.readFrame(state.frame, *truth)) continue;
+        report.framesCompared++;
+
+        track(report.maxOilError,
+              state.oilTemperature / StreamState::OIL_SCALE,
+              truth->oilTemperature);
+        track(report.maxOilError,
+              state.targetTemperature / StreamState::OIL_SCALE,
+              truth->targetTemperature);
+        track(report.maxOilError,
+              state.polarCompounds / StreamState::OIL_SCALE,
+              truth->polarCompounds);
+        track(report.maxSimTimeError, (float)state.simTimeMs,
+              truth->simTime * 1000.0f);
+
+        if ((int)state.fries.size() != truth->numFries ||
+            (int)state.bubbles.size() != truth->numBubbles) {
+            report.countMismatches++;
+            continue;
+        }
+
+        for (size_t i = 0; i < state.fries.size(); i++) {
+            const int32_t* q = state.fries[i].value;
+            auto value = [&](int field) {
+                return q[field] / StreamState::getFryScale(field);
+            };
+            track(report.maxPositionError, value(StreamState::Fry::X),
+                  truth->fryX[i]);
+            track(report.maxPositionError, value(StreamState::Fry::Y),
+                  truth->fryY[i]);
+            track(report.maxSizeError, value(StreamState::Fry::WIDTH),
+                  truth->fryWidth[i]);
+            track(report.maxSizeError, value(StreamState::Fry::HEIGHT),
+                  truth->fryHeight[i]);
+            track(report.maxTemperatureError,
+                  value(StreamState::Fry::TEMPERATURE),
+                  truth->fryTemperature[i]);
+            track(report.maxFractionError, value(StreamState::Fry::MOISTURE),
+                  truth->fryMoisture[i]);
+            track(report.maxFractionError,
+                  value(StreamState::Fry::COOKEDNESS),
+                  truth->fryCookedness[i]);
+            track(report.maxFractionError, value(StreamState::Fry::CRUST),
+                  truth->fryCrust[i]);
+        }
+
+        for (size_t i = 0; i < state.bubbles.size(); i++) {
+            const StreamState::Bubble& bubble = state.bubbles[i];
+            int kind = truth->bubbleType[i] * 2 + truth->bubbleSurfaced[i];
+            if (bubble.id != truth->bubbleId[i] ||
+                bubble.value[StreamState::Bubble::KIND] != kind) {
+                report.countMismatches++;
+            }
+            track(report.maxPositionError,
+                  bubble.value[StreamState::Bubble::X] /
+                      StreamState::POSITION_SCALE,
+                  truth->bubbleX[i]);
+            track(report.maxPositionError,
+                  bubble.value[StreamState::Bubble::Y] /
+                      StreamState::POSITION_SCALE,
+                  truth->bubbleY[i]);
+            track(report.maxBubbleSizeError,
+                  bubble.value[StreamState::Bubble::SIZE] /
+                      StreamState::SIZE_SCALE,
+                  truth->bubbleSize[i]);
+        }
+    }
+
+    float seconds = std::chrono::duration<float>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    int deltas = report.framesDecoded - report.keyframes;
+    report.bytesPerSecond = seconds > 0 ? totalBytes / seconds : 0;
+    report.meanKeyframeBytes =
+        report.keyframes > 0 ? (float)keyframeBytes / report.keyframes : 0;
+    report.meanDeltaBytes = deltas > 0 ? (float)deltaBytes / deltas : 0;
+
+    // Half a quantization step, plus float rounding of the real values
+    const float slack = 1.001f;
+    report.withinQuantization =
+        report.framesCompared > 0 && report.countMismatches == 0 &&
+        report.maxPositionError <=
+            0.5f / StreamState::POSITION_SCALE * slack &&
+        report.maxSizeError <= 0.5f / StreamState::POSITION_SCALE * slack &&
+        report.maxBubbleSizeError <=
+            0.5f / StreamState::SIZE_SCALE * slack &&
+        report.maxTemperatureError <=
+            0.5f / StreamState::TEMPERATURE_SCALE * slack &&
+        report.maxFractionError <=
+            0.5f / StreamState::FRACTION_SCALE * slack &&
+        report.maxOilError <= 0.5f / StreamState::OIL_SCALE * slack &&
+        report.maxSimTimeError <= 0.5f * slack;
+    return report;
+}
+
+std::string formatStreamCheck(const StreamCheckReport& report) {
+    char text[1024];
+    snprintf(text, sizeof(text),
+             "frames decoded      %d (%d keyframes), %d compared\n"
+             "count/id mismatches %d\n"
+             "max error           position %.4f px, size %.4f px,\n"
+             "                    bubble size %.4f px, temperature %.4f C,\n"
+             "                    fraction %.5f, oil %.4f, time %.3f ms\n"
+             "message size        keyframe %.0f B, delta %.0f B\n"
+             "bandwidth           %.1f KB/s\n"
+             "%s\n",
+             report.framesDecoded, report.keyframes, report.framesCompared,
+             report.countMismatches, report.maxPositionError,
+             report.maxSizeError, report.maxBubbleSizeError,
+             report.maxTemperatureError, report.maxFractionError,
+             report.maxOilError, report.maxSimTimeError,
+             report.meanKeyframeBytes,
+             report.meanDeltaBytes, report.bytesPerSecond / 1000.0f,
+             report.withinQuantization ? "PASS: within quantization error"
+                                       : "FAIL");
+    return text;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Result of comparing a dashboard stream against the publisher's own
+ * frames. Errors are the largest absolute differences seen between a
+ * decoded value and the shared-memory frame with the same number.
+ */
+struct StreamCheckReport {
+    int framesDecoded;
+    int framesCompared;  // decoded frames still present in the ring
+    int keyframes;
+    int countMismatches;  // fry or bubble counts, or bubble ids
+    float maxPositionError;     // px
+    float maxSizeError;         // px, fries
+    float maxBubbleSizeError;   // px
+    float maxTemperatureError;  // °C
+    float maxFractionError;     // moisture, cookedness, crust
+    float maxOilError;          // oil and target °C, TPC %
+    float maxSimTimeError;      // ms
+    float bytesPerSecond;
+    float meanKeyframeBytes;
+    float meanDeltaBytes;
+    bool withinQuantization;
+};
+
+/**
+ * Connects to fryer <fryer>'s dashboard stream like a browser would,
+ * decodes numFrames messages and checks each against the same frame read
+ * from the fryer's shared-memory ring. Requires a running --serve.
+ */
+StreamCheckReport checkStateStream(int fryer, int numFrames);
+
+std::string formatStreamCheck(const StreamCheckReport& report);
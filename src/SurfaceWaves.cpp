@@ -0,0 +1,83 @@
+#include "SurfaceWaves.h"
+
+#include <algorithm>
+#include <cmath>
+
+SurfaceWaves::SurfaceWaves(float l, float r, int numCells) {
+    left = l;
+    right = r;
+    waveSpeed = 160.0f;
+    damping = 1.8f;
+    height.assign(numCells, 0.0f);
+    velocity.assign(numCells, 0.0f);
+    cellWidth = (right - left) / (numCells - 1);
+}
+
+void SurfaceWaves::update(float dt) {
+    int n = (int)height.size();
+    if (dt <= 0 || n < 3) return;
+
+    // CFL: c·dt/dx <= 1 (0.9 for margin)
+    float maxStep = 0.9f * cellWidth / waveSpeed;
+    int substeps = std::max(1, (int)ceil(dt / maxStep));
+    float h = dt / substeps;
+    float stiffness = waveSpeed * waveSpeed / (cellWidth * cellWidth) * h;
+    float decay = exp(-damping * h);
+
+    float* heights = height.data();
+    float* velocities = velocity.data();
+    for (int step = 0; step < substeps; step++) {
+        // Reflecting walls: mirror the neighbouring cell
+        velocities[0] = (velocities[0] +
+                         stiffness * 2.0f * (heights[1] - heights[0])) *
+                        decay;
+        velocities[n - 1] =
+            (velocities[n - 1] +
+             stiffness * 2.0f * (heights[n - 2] - heights[n - 1])) *
+            decay;
+
+        for (int i = 1; i < n - 1; i++) {
+            float laplacian =
+                heights[i - 1] - 2.0f * heights[i] + heights[i + 1];
+            velocities[i] = (velocities[i] + stiffness * laplacian) * decay;
+        }
+        for (int i = 0; i < n; i++) {
+            heights[i] += velocities[i] * h;
+        }
+    }
+}
+
+void SurfaceWaves::clear() {
+    std::fill(height.begin(), height.end(), 0.0f);
+    std::fill(velocity.begin(), velocity.end(), 0.0f);
+}
+
+void SurfaceWaves::excite(float x, float strength, float width) {
+    int n = (int)height.size();
+    width = std::max(width, cellWidth);
+    int centre = (int)((x - left) / cellWidth + 0.5f);
+    int reach = (int)ceil(2.5f * width / cellWidth);
+
+    for (int i = std::max(0, centre - reach);
+         i <= std::min(n - 1, centre + reach); i++) {
+        // Ricker profile: zero net impulse, so excitation conserves volume
+        float d = (left + i * cellWidth - x) / width;
+        velocity[i] += strength * (1.0f - 2.0f * d * d) * exp(-d * d);
+    }
+}
+
+float SurfaceWaves::getHeight(float x) const {
+    float cell = (x - left) / cellWidth;
+    if (cell <= 0) return height.front();
+    int i = (int)cell;
+    if (i >= (int)height.size() - 1) return height.back();
+    float t = cell - i;
+    return height[i] * (1.0f - t) + height[i + 1] * t;
+}
+
+const std::vector<float>& SurfaceWaves::getHeights() const { return height; }
+
+void SurfaceWaves::setHeights(const float* heights, int count) {
+    count = std::min(count, (int)height.size());
+    std::copy(heights, heights + count, height.begin());
+}
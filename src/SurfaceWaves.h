@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * Height field of the oil surface across the fryer width, solved as the
+ * damped 1D wave equation ∂²h/∂t² = c² ∂²h/∂x² - k ∂h/∂t with reflecting
+ * walls. Heights are upward displacements in pixels.
+ *
+ * Bubbles breaking the surface and fries crossing it excite the field with
+ * zero-mean (Ricker) velocity impulses, which leave the oil volume
+ * unchanged; the field in turn sets the rendered surface and the level at
+ * which bubbles pop.
+ *
+ * Integration is symplectic Euler, sub-stepped to stay within the CFL limit.
+ * Each substep is two branch-free passes over contiguous arrays (velocity
+ * from the Laplacian, then height) that the compiler vectorizes.
+ */
+class SurfaceWaves {
+   public:
+    SurfaceWaves(float left, float right, int numCells = 2048);
+
+    void update(float dt);
+
+    // Flattens the surface and stops it moving
+    void clear();
+
+    // Adds a velocity impulse (px/s at the centre), ~width px half-width
+    void excite(float x, float strength, float width);
+    float getHeight(float x) const;
+
+    // Per-cell heights, for copying the surface between processes; setting
+    // them overwrites the first count cells and leaves velocities alone
+    const std::vector<float>& getHeights() const;
+    void setHeights(const float* heights, int count);
+
+    float left;
+    float right;
+    float waveSpeed;  // px/s
+    float damping;    // 1/s
+
+   private:
+    std::vector<float> height;  // Upward displacement per cell, px
+    std::vector<float> velocity;
+    float cellWidth;
+};
@@ -0,0 +1,120 @@
+#include "VoidFractionField.h"
+
+#include <algorithm>
+#include <cmath>
+
+VoidFractionField::VoidFractionField(float l, float t, float right,
+                                     float bottom, int numCols, int numRows) {
+    left = l;
+    top = t;
+    cols = numCols;
+    rows = numRows;
+    cellWidth = (right - left) / cols;
+    cellHeight = (bottom - top) / rows;
+    density.assign(cols * rows, 0.0f);
+    surfaceOutflow.assign(cols, 0.0f);
+    pixels.assign(cols * rows * 4, 0);
+}
+
+void VoidFractionField::deposit(float x, float y, float count) {
+    int col = ofClamp((int)((x - left) / cellWidth), 0, cols - 1);
+    int row = ofClamp((int)((y - top) / cellHeight), 0, rows - 1);
+    density[row * cols + col] += count;
+}
+
+void VoidFractionField::update(float dt, float riseSpeed) {
+    // Fraction of each cell's content that moves up one row this step
+    float f = std::min(1.0f, riseSpeed * dt / cellHeight);
+
+    float* d = density.data();
+    float* out = surfaceOutflow.data();
+    for (int c = 0; c < cols; c++) {
+        out[c] = d[c] * f;
+    }
+
+    // Row by row from the surface down; each row keeps (1 - f) of itself
+    // and receives f of the row below. Inner loops run across columns.
+    for (int r = 0; r < rows - 1; r++) {
+        float* row = d + r * cols;
+        const float* below = row + cols;
+        for (int c = 0; c < cols; c++) {
+            row[c] = row[c] * (1.0f - f) + below[c] * f;
+        }
+    }
+    float* bottomRow = d + (rows - 1) * cols;
+    for (int c = 0; c < cols; c++) {
+        bottomRow[c] *= 1.0f - f;
+    }
+}
+
+int VoidFractionField::extract(float x, float y, float radius, int maxCount,
+                               ofVec2f* positions, std::mt19937& rng) {
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    int c0 = std::max(0, (int)((x - radius - left) / cellWidth));
+    int c1 = std::min(cols - 1, (int)((x + radius - left) / cellWidth));
+    int r0 = std::max(0, (int)((y - radius - top) / cellHeight));
+    int r1 = std::min(rows - 1, (int)((y + radius - top) / cellHeight));
+
+    int count = 0;
+    for (int r = r0; r <= r1 && count < maxCount; r++) {
+        for (int c = c0; c <= c1 && count < maxCount; c++) {
+            float cx = left + (c + 0.5f) * cellWidth;
+            float cy = top + (r + 0.5f) * cellHeight;
+            if ((cx - x) * (cx - x) + (cy - y) * (cy - y) > radius * radius) {
+                continue;
+            }
+
+            float& cell = density[r * cols + c];
+            while (cell >= 1.0f && count < maxCount) {
+                cell -= 1.0f;
+                positions[count++] =
+                    ofVec2f(cx + jitter(rng) * cellWidth,
+                            cy + jitter(rng) * cellHeight);
+            }
+        }
+    }
+    return count;
+}
+
+float VoidFractionField::getTotal() const {
+    float total = 0;
+    for (float d : density) total += d;
+    return total;
+}
+
+const std::vector<float>& VoidFractionField::getDensity() const {
+    return density;
+}
+
+void VoidFractionField::setDensity(const float* counts, int count) {
+    count = std::min(count, (int)density.size());
+    std::copy(counts, counts + count, density.begin());
+}
+
+float VoidFractionField::getColumnX(int col) const {
+    return left + (col + 0.5f) * cellWidth;
+}
+
+void VoidFractionField::clear() {
+    std::fill(density.begin(), density.end(), 0.0f);
+    std::fill(surfaceOutflow.begin(), surfaceOutflow.end(), 0.0f);
+}
+
+void VoidFractionField::draw(const ofColor& color) {
+    // Opacity saturates with a few bubbles per cell, like overlapping discs
+    for (int i = 0; i < cols * rows; i++) {
+        float alpha = 1.0f - exp(-0.35f * density[i]);
+        pixels[i * 4 + 0] = color.r;
+        pixels[i * 4 + 1] = color.g;
+        pixels[i * 4 + 2] = color.b;
+        pixels[i * 4 + 3] = (unsigned char)(alpha * color.a);
+    }
+
+    if (!texture.isAllocated()) {
+        texture.allocate(cols, rows, GL_RGBA);
+        texture.setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+    }
+    texture.loadData(pixels.data(), cols, rows, GL_RGBA);
+    ofSetColor(255);
+    texture.draw(left, top, cols * cellWidth, rows * cellHeight);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "ofMain.h"
+
+/**
+ * Eulerian stand-in for large numbers of small bubbles: a coarse grid over
+ * the oil holding the number of bubbles per cell (a void fraction in bubble
+ * units). Bubbles deposited into it rise at a common speed, are carried out
+ * through the surface row, and render as one density texture, so the cost
+ * of a full-basket boil is set by the grid size, not the bubble count.
+ *
+ * Transport is first-order upwind in the vertical: conservative, positive
+ * and stable while riseSpeed * dt stays below one cell. Each update records
+ * how many bubbles left through the surface in each column, for the caller
+ * to turn into pops.
+ */
+class VoidFractionField {
+   public:
+    VoidFractionField(float left, float top, float right, float bottom,
+                      int cols = 96, int rows = 48);
+
+    void deposit(float x, float y, float count);
+    void update(float dt, float riseSpeed);
+
+    // Removes whole bubbles within radius of (x, y), up to maxCount, and
+    // returns positions drawn from rng within their cells; used to
+    // re-materialize particles
+    int extract(float x, float y, float radius, int maxCount,
+                ofVec2f* positions, std::mt19937& rng);
+
+    float getTotal() const;
+
+    // Row-major cell counts, row 0 at the surface, for copying the field
+    // between processes; setting overwrites the first count cells
+    const std::vector<float>& getDensity() const;
+    void setDensity(const float* counts, int count);
+
+    float getColumnX(int col) const;
+    void clear();
+    void draw(const ofColor& color);
+
+    int cols;
+    int rows;
+    std::vector<float> surfaceOutflow;  // Bubbles per column, last update
+
+   private:
+    std::vector<float> density;
+    float left;
+    float top;
+    float cellWidth;
+    float cellHeight;
+
+    std::vector<unsigned char> pixels;
+    ofTexture texture;
+};
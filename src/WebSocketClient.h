@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Blocking WebSocket client for loopback tools such as the stream check.
+ * Receives unfragmented binary messages from WebSocketServer; sends nothing
+ * after the handshake.
+ */
+class WebSocketClient {
+   public:
+    WebSocketClient();
+    ~WebSocketClient();
+
+    bool connect(const std::string& host, int port);
+    void close();
+
+    // Waits up to timeoutMs for the next message; false on timeout, close
+    // or error
+    bool receive(std::string& message, int timeoutMs);
+
+   private:
+    bool fill(int timeoutMs);
+
+    int fd;
+    std::string buffer;
+};
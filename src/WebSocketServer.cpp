@@ -0,0 +1,363 @@
+#include "WebSocketServer.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
+#include "ofMain.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: SO_NOSIGPIPE is set per socket instead
+#endif
+
+namespace {
+
+const char* HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+uint32_t rotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// SHA-1 of the handshake key; only used for Sec-WebSocket-Accept
+std::string sha1(const std::string& input) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+                     0xC3D2E1F0};
+    std::string data = input;
+    uint64_t bitLength = (uint64_t)input.size() * 8;
+    data.push_back((char)0x80);
+    while (data.size() % 64 != 56) data.push_back(0);
+    for (int i = 7; i >= 0; i--) data.push_back((char)(bitLength >> (i * 8)));
+
+    for (size_t chunk = 0; chunk < data.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            const unsigned char* p =
+                (const unsigned char*)data.data() + chunk + i * 4;
+            w[i] = (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+        }
+        for (int i = 16; i < 80; i++) {
+            w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotateLeft(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::string digest;
+    for (int i = 0; i < 5; i++) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            digest.push_back((char)(h[i] >> shift));
+        }
+    }
+    return digest;
+}
+
+std::string base64(const std::string& input) {
+    static const char* alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < input.size(); i += 3) {
+        uint32_t n = (unsigned char)input[i] << 16;
+        if (i + 1 < input.size()) n |= (unsigned char)input[i + 1] << 8;
+        if (i + 2 < input.size()) n |= (unsigned char)input[i + 2];
+        out.push_back(alphabet[(n >> 18) & 63]);
+        out.push_back(alphabet[(n >> 12) & 63]);
+        out.push_back(i + 1 < input.size() ? alphabet[(n >> 6) & 63] : '=');
+        out.push_back(i + 2 < input.size() ? alphabet[n & 63] : '=');
+    }
+    return out;
+}
+
+// Value of an HTTP header, matched case-insensitively; empty if absent
+std::string getHeader(const std::string& request, const std::string& name) {
+    std::string lower = request;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    std::string key = "\r\n" + name + ":";
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+    size_t start = lower.find(key);
+    if (start == std::string::npos) return "";
+    start += key.size();
+    size_t end = request.find("\r\n", start);
+    std::string value = request.substr(start, end - start);
+    size_t first = value.find_first_not_of(" \t");
+    size_t last = value.find_last_not_of(" \t");
+    return first == std::string::npos ? ""
+                                       : value.substr(first, last - first + 1);
+}
+
+const int OPCODE_BINARY = 0x2;
+const int OPCODE_CLOSE = 0x8;
+const int OPCODE_PING = 0x9;
+const int OPCODE_PONG = 0xA;
+
+// Unfragmented, unmasked frame header (server to client)
+void appendFrameHeader(std::string& out, size_t length,
+                       int opcode = OPCODE_BINARY) {
+    out.push_back((char)(0x80 | opcode));
+    if (length < 126) {
+        out.push_back((char)length);
+    } else if (length < 65536) {
+        out.push_back((char)126);
+        out.push_back((char)(length >> 8));
+        out.push_back((char)length);
+    } else {
+        out.push_back((char)127);
+        for (int i = 7; i >= 0; i--) out.push_back((char)(length >> (i * 8)));
+    }
+}
+
+}  // namespace
+
+WebSocketServer::WebSocketServer(int port) : port(port), listenFd(-1) {
+    pagePath = ofToDataPath("dashboard.html");
+}
+
+WebSocketServer::~WebSocketServer() { stop(); }
+
+bool WebSocketServer::start() {
+    stop();
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listenFd, 8) != 0) {
+        ofLogError("WebSocketServer") << "cannot listen on port " << port;
+        stop();
+        return false;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+    ofLogNotice("WebSocketServer") << "dashboard at http://localhost:" << port;
+    return true;
+}
+
+void WebSocketServer::stop() {
+    for (auto& client : clients) ::close(client.fd);
+    clients.clear();
+    if (listenFd >= 0) ::close(listenFd);
+    listenFd = -1;
+}
+
+void WebSocketServer::poll() {
+    if (listenFd < 0) return;
+
+    int fd;
+    while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+        int noSigPipe = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe,
+                   sizeof(noSigPipe));
+#endif
+        Client client;
+        client.fd = fd;
+        client.upgraded = false;
+        client.waitingForKeyframe = true;
+        client.closeWhenFlushed = false;
+        clients.push_back(client);
+    }
+
+    for (auto& client : clients) {
+        readRequest(client);
+        flush(client);
+    }
+    clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                 [](const Client& c) { return c.fd < 0; }),
+                  clients.end());
+}
+
+void WebSocketServer::broadcast(const std::string& message, bool keyframe) {
+    for (auto& client : clients) {
+        if (!client.upgraded || client.fd < 0 || client.closeWhenFlushed) {
+            continue;
+        }
+        if (client.backlog.size() > MAX_BACKLOG) {
+            client.waitingForKeyframe = true;
+        }
+        if (client.waitingForKeyframe) {
+            if (!keyframe || client.backlog.size() > MAX_BACKLOG) continue;
+            client.waitingForKeyframe = false;
+        }
+        appendFrameHeader(client.backlog, message.size());
+        client.backlog += message;
+        flush(client);
+    }
+}
+
+int WebSocketServer::getNumClients() const {
+    return (int)std::count_if(
+        clients.begin(), clients.end(),
+        [](const Client& c) { return c.upgraded && c.fd >= 0; });
+}
+
+void WebSocketServer::readRequest(Client& client) {
+    char buffer[4096];
+    while (client.fd >= 0) {
+        ssize_t received = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            client.request.append(buffer, received);
+            continue;
+        }
+        if (received == 0 ||
+            (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            drop(client);
+        }
+        break;
+    }
+    if (client.fd < 0 || client.closeWhenFlushed) return;
+    if (client.upgraded) {
+        readFrames(client);
+        return;
+    }
+
+    if (client.request.find("\r\n\r\n") != std::string::npos) {
+        respond(client);
+    } else if (client.request.size() > MAX_REQUEST) {
+        drop(client);
+    }
+}
+
+void WebSocketServer::readFrames(Client& client) {
+    // Client frames are masked (RFC 6455 5.3). Data frames are discarded;
+    // pings get a pong, and a Close is echoed before the connection closes.
+    std::string& in = client.request;
+    size_t offset = 0;
+    while (in.size() - offset >= 2) {
+        const unsigned char* frame = (const unsigned char*)in.data() + offset;
+        int opcode = frame[0] & 0x0F;
+        size_t length = frame[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            header += 2;
+            if (in.size() - offset < header) break;
+            length = (frame[2] << 8) | frame[3];
+        } else if (length == 127) {
+            header += 8;
+            if (in.size() - offset < header) break;
+            length = 0;
+            for (int i = 0; i < 8; i++) length = (length << 8) | frame[2 + i];
+        }
+        bool masked = frame[1] & 0x80;
+        if (masked) header += 4;
+        if (length > MAX_REQUEST) {
+            drop(client);
+            return;
+        }
+        if (in.size() - offset < header + length) break;
+
+        std::string payload = in.substr(offset + header, length);
+        if (masked) {
+            const unsigned char* mask = frame + header - 4;
+            for (size_t i = 0; i < length; i++) payload[i] ^= mask[i % 4];
+        }
+        offset += header + length;
+
+        if (opcode == OPCODE_PING) {
+            appendFrameHeader(client.backlog, length, OPCODE_PONG);
+            client.backlog += payload;
+        } else if (opcode == OPCODE_CLOSE) {
+            // Echo the status code, if any, and close once it is sent
+            std::string status = payload.substr(0, 2);
+            appendFrameHeader(client.backlog, status.size(), OPCODE_CLOSE);
+            client.backlog += status;
+            client.closeWhenFlushed = true;
+            in.clear();
+            return;
+        }
+    }
+    in.erase(0, offset);
+}
+
+void WebSocketServer::respond(Client& client) {
+    std::string key = getHeader(client.request, "Sec-WebSocket-Key");
+    if (!key.empty()) {
+        client.backlog +=
+            "HTTP/1.1 101 Switching Protocols\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Accept: " +
+            base64(sha1(key + HANDSHAKE_GUID)) + "\r\n\r\n";
+        client.upgraded = true;
+        client.request.clear();
+        return;
+    }
+
+    // Any other request gets the dashboard page
+    std::ifstream file(pagePath, std::ios::binary);
+    std::stringstream page;
+    page << file.rdbuf();
+    std::string body = file ? page.str() : "dashboard.html not found\n";
+    client.backlog += std::string(file ? "HTTP/1.1 200 OK\r\n"
+                                       : "HTTP/1.1 404 Not Found\r\n") +
+                      "Content-Type: text/html; charset=utf-8\r\n"
+                      "Content-Length: " +
+                      std::to_string(body.size()) +
+                      "\r\nConnection: close\r\n\r\n" + body;
+    client.closeWhenFlushed = true;
+}
+
+void WebSocketServer::flush(Client& client) {
+    while (client.fd >= 0 && !client.backlog.empty()) {
+        ssize_t sent = send(client.fd, client.backlog.data(),
+                            client.backlog.size(), MSG_NOSIGNAL);
+        if (sent > 0) {
+            client.backlog.erase(0, sent);
+            continue;
+        }
+        if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+            errno != EINTR) {
+            drop(client);
+        }
+        return;
+    }
+    if (client.fd >= 0 && client.closeWhenFlushed) drop(client);
+}
+
+void WebSocketServer::drop(Client& client) {
+    if (client.fd >= 0) ::close(client.fd);
+    client.fd = -1;
+    client.backlog.clear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * Minimal non-blocking WebSocket (RFC 6455) broadcast server on the
+ * loopback interface, polled from the simulation loop. Plain HTTP requests
+ * get the page at pagePath, so a browser can load the client and open the
+ * socket from the same port. Messages only flow server to client: client
+ * data frames are discarded, pings are answered, and a client's Close is
+ * echoed before the connection is closed.
+ *
+ * Each client has its own output backlog. Broadcasts are stream deltas, so
+ * a client that falls more than MAX_BACKLOG bytes behind (or has just
+ * connected) skips messages until the next keyframe instead of stalling
+ * the simulation or being sent a stream it can't decode.
+ */
+class WebSocketServer {
+   public:
+    static const size_t MAX_BACKLOG = 1 << 20;
+    static const size_t MAX_REQUEST = 8192;
+
+    explicit WebSocketServer(int port);
+    ~WebSocketServer();
+
+    bool start();
+    void stop();
+
+    // Accepts connections, completes handshakes and flushes output
+    void poll();
+
+    void broadcast(const std::string& message, bool keyframe);
+
+    // Clients past the handshake
+    int getNumClients() const;
+
+    std::string pagePath;
+
+   private:
+    struct Client {
+        int fd;
+        bool upgraded;
+        bool waitingForKeyframe;
+        bool closeWhenFlushed;
+        std::string request;  // Handshake, then incoming frame bytes
+        std::string backlog;
+    };
+
+    void readRequest(Client& client);
+    void readFrames(Client& client);
+    void respond(Client& client);
+    void flush(Client& client);
+    void drop(Client& client);
+
+    int port;
+    int listenFd;
+    std::vector<Client> clients;
+};
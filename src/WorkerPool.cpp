@@ -0,0 +1,91 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(int numThreads) {
+    currentTask = nullptr;
+    taskCount = 0;
+    nextIndex = 0;
+    activeWorkers = 0;
+    generation = 0;
+    stopping = false;
+
+    // Caller participates in each batch, so spawn one fewer than the cores
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < numThreads - 1; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int WorkerPool::getNumThreads() const { return (int)workers.size() + 1; }
+
+void WorkerPool::parallelFor(int count,
+                             const std::function<void(int)>& task) {
+    if (count <= 0) return;
+
+    if (workers.empty() || count == 1) {
+        for (int i = 0; i < count; i++) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        nextIndex = 0;
+        activeWorkers = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return activeWorkers == 0; });
+    currentTask = nullptr;
+}
+
+void WorkerPool::workerLoop() {
+    unsigned long seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] {
+                return stopping || generation != seenGeneration;
+            });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        runTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            activeWorkers--;
+        }
+        finished.notify_one();
+    }
+}
+
+void WorkerPool::runTasks() {
+    // Dynamic scheduling: rollouts finish early once their event fires, so
+    // static partitioning would leave threads idle
+    while (true) {
+        int i = nextIndex.fetch_add(1);
+        if (i >= taskCount) break;
+        (*currentTask)(i);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads for batched headless simulation. Threads are
+ * created once and parked between batches so that short, frequent batches
+ * (e.g. controller rollouts every 100 ms) do not pay thread start-up cost.
+ *
+ * parallelFor blocks the caller, which also takes part in the work, until
+ * every index has been processed. Tasks must not call back into the pool.
+ */
+class WorkerPool {
+   public:
+    explicit WorkerPool(int numThreads = 0);
+    ~WorkerPool();
+
+    void parallelFor(int count, const std::function<void(int)>& task);
+    int getNumThreads() const;
+
+   private:
+    void workerLoop();
+    void runTasks();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    const std::function<void(int)>* currentTask;
+    int taskCount;
+    std::atomic<int> nextIndex;
+    int activeWorkers;
+    unsigned long generation;
+    bool stopping;
+};
@@ -8,23 +8,495 @@
  *   - Realistic oil thermodynamics (Arrhenius viscosity, thermal expansion)
  *   - Physics-based potato behavior (heat transfer, moisture loss, buoyancy)
  *   - Visual effects (bubbles, steam, oil surface effects, heat haze)
+ *   - Procedural frying sound synthesized from bubble surface events
  *   - Interactive controls (temperature adjustment, drag fry, reset)
  *
  * Controls:
  *   UP/DOWN  - Adjust oil temperature (160-190°C)
+ *   M        - Toggle model-predictive temperature control
+ *   S        - Toggle frying sound
+ *   L        - Toggle late-latched dragging
+ *   O        - Toggle profiler overlay (frame times, input latency)
  *   SPACE    - Drop/remove potato fry
+ *   B        - Drop/remove a full basket of fries
  *   P        - Pause/unpause simulation
  *   R        - Reset simulation
- *   MOUSE    - Drag fry in oil
+ *   MOUSE    - Drag fry in oil; hover to inspect (resolved physics);
+ *              drag across empty oil to select fries and move them together
+ *
+ * Headless modes (no window):
+ *   --search-recipes [prefix]  Evolutionary search over two-stage frying
+ *                              recipes; writes <prefix>_best.csv and
+ *                              <prefix>_pareto.csv (default prefix "recipes")
+ *   --simulate-kitchen [n]     Full day of order flow for 1..n fryers
+ *                              (default 4); prints wait times and oil sag
+ *   --fryer-rom [days]         Fits the reduced-order fryer model, reports
+ *                              its error against the full model, and times
+ *                              <days> reduced fryer-days (default 1000000)
+ *   --render-audio [s] [path]  Simulates <s> seconds of frying one fry at
+ *                              175 C and renders its bubble sound to a WAV
+ *                              file (default 90 s, "frying.wav")
+ *   --serve [n] [basket]       Runs fryer <n> (default 1) windowless and
+ *                              publishes every frame to shared memory;
+ *                              drops one fry, or a basket with "basket";
+ *                              also streams to a browser dashboard at
+ *                              http://localhost:<8700 + n>
+ *   --stream-check [n] [frames]
+ *                              Decodes <frames> (default 600) messages of
+ *                              fryer <n>'s dashboard stream and checks them
+ *                              against its shared-memory frames
+ *   --scenarios [n] [hours]    Runs <n> scripted fryers (default 1000) for
+ *                              <hours> of simulation time (default 1): drop,
+ *                              shake at 30 s, lift at 180 s or at DONE,
+ *                              next drop once the oil is back to 175 C
+ *   --scenario <file> [runs] [csv]
+ *                              Plays a scenario file (see bin/data) on
+ *                              <runs> headless fryers (default 1), fry cuts
+ *                              seeded per run; writes its recorded outputs
+ *                              to <csv> (default <name>.csv)
+ *   --job-server [path]        Serves rollout, sweep and recipe-search jobs
+ *                              over a Unix socket (default
+ *                              /tmp/deepfry-jobs.sock) until interrupted
+ *   --job <json> [path]        Sends one request to the job server and
+ *                              prints its events, e.g.
+ *                              '{"op":"submit","type":"rollout"}'
+ *   --twin [source]            Digital twin of a real fryer: follows its
+ *                              sensor feed ("udp:<port>" or a file being
+ *                              appended to, default udp:8790) and prints
+ *                              each basket's predicted DONE time
+ *   --replay-sensor <log> [target] [speed]
+ *                              Replays a sensor log or scenario CSV to a
+ *                              twin's source at <speed> x real time
+ *                              (default udp:8790, 1)
+ *   --validate-log <log>       Replays every basket in a fryer log (CSV or
+ *                              binary) under its logged oil temperature and
+ *                              compares with the drop-time prediction
+ *   --convert-log <log> <out>  Rewrites a CSV fryer log as a binary log
+ *
+ * Viewer mode:
+ *   --view [n]                 Draws the frames published by fryer <n>;
+ *                              keys 1-9 switch fryers, hover inspects
+ *   --play <file>              Plays a scenario file on the windowed fryer
+ *                              and records to data/<name>_viewer.csv
+ *   --replay-log <log>         Drives the windowed fryer's oil from a
+ *                              recorded fryer log
+ *   --record-input <file>      Runs the windowed fryer, recording its
+ *                              random seed and applied input stamped with
+ *                              the fry step
+ *   --replay-input <file>      Runs the windowed fryer from recorded input
+ *                              instead of the mouse and keyboard
  *
  * Eric Hobson
  * COMP 4900L - Fall 2025
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AudioRender.h"
+#include "DigitalTwin.h"
+#include "FryerLog.h"
+#include "JobServer.h"
+#include "KitchenSim.h"
+#include "LogValidation.h"
+#include "RecipeSearch.h"
+#include "ReducedFryerModel.h"
+#include "Scenario.h"
+#include "ScenarioFile.h"
+#include "SensorFeed.h"
+#include "StreamCheck.h"
 #include "ofApp.h"
 #include "ofMain.h"
 
-int main() {
+namespace {
+
+volatile std::sig_atomic_t stopSignalled = 0;
+
+void onStopSignal(int) { stopSignalled = 1; }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "--search-recipes") {
+        std::string prefix = argc > 2 ? argv[2] : "recipes";
+        RecipeSearch search;
+        search.run();
+        bool ok = search.writeCsv(prefix + "_best.csv", search.best) &&
+                  search.writeCsv(prefix + "_pareto.csv", search.pareto);
+        return ok ? 0 : 1;
+    }
+
+    if (mode == "--simulate-kitchen") {
+        int maxFryers = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4;
+        WorkerPool pool;
+        KitchenSim kitchen;
+        kitchen.buildResponseTable(pool);
+
+        printf("fryers  orders  baskets  mean_wait_s  p95_wait_s  max_wait_s"
+               "  max_queue  utilization  min_oil_c\n");
+        for (int n = 1; n <= maxFryers; n++) {
+            KitchenReport r = kitchen.run(n);
+            printf("%6d  %6d  %7d  %11.1f  %10.1f  %10.1f  %9d  %11.2f"
+                   "  %9.1f\n",
+                   r.numFryers, r.ordersServed, r.basketsCooked, r.meanWait,
+                   r.p95Wait, r.maxWait, r.maxQueuedPortions, r.utilization,
+                   r.minOilTemperature);
+        }
+        return 0;
+    }
+
+    if (mode == "--fryer-rom") {
+        int numDays = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000000;
+        const float dt = 0.25f;
+        WorkerPool pool;
+        FryerDayConfig base;
+        ReducedFryerModel model;
+        model.fit(pool, base, dt);
+        printf("%s", model.validate(pool, base, dt).c_str());
+
+        // Throughput: demand varied per day so nothing is hoisted
+        auto start = std::chrono::steady_clock::now();
+        int numThreads = pool.getNumThreads();
+        std::vector<double> energy(numThreads, 0.0);
+        pool.parallelFor(numThreads, [&](int thread) {
+            FryerDayConfig config = base;
+            for (int day = thread; day < numDays; day += numThreads) {
+                config.basketMass = 0.4f + 0.4f * (day % 97) / 96.0f;
+                energy[thread] += model.simulateDay(config).heaterEnergy;
+            }
+        });
+        float seconds = std::chrono::duration<float>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+        printf("%d reduced fryer-days in %.2f s (%.1f million/min, %d "
+               "threads)\n",
+               numDays, seconds, numDays / seconds * 60.0f / 1e6f,
+               numThreads);
+        return 0;
+    }
+
+    if (mode == "--render-audio") {
+        float duration = argc > 2 ? std::max(1.0f, (float)std::atof(argv[2]))
+                                  : 90.0f;
+        std::string path = argc > 3 ? argv[3] : "frying.wav";
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<BubbleSoundEvent> events =
+            simulateFryingEvents(175.0f, duration);
+        bool ok = renderFryingWav(events, duration, 48000.0f, path);
+        float seconds = std::chrono::duration<float>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+        printf("%zu bubble events, %.0f s of audio in %.2f s -> %s\n",
+               events.size(), duration, seconds, path.c_str());
+        return ok ? 0 : 1;
+    }
+
+    if (mode == "--serve") {
+        int fryer = argc > 2 ? std::max(1, std::atoi(argv[2])) - 1 : 0;
+        bool basket = argc > 3 && std::string(argv[3]) == "basket";
+
+        // Same 1024x768 scene geometry as the windowed app
+        ofWindowSettings settings;
+        settings.setSize(1024, 768);
+        auto window = std::make_shared<ofAppNoWindow>();
+        ofInit();
+        ofGetMainLoop()->addWindow(window);
+        window->setup(settings);
+        ofRunApp(window, std::make_shared<ofApp>(ofApp::RUN_PUBLISH, fryer,
+                                                 basket));
+        return ofRunMainLoop();
+    }
+
+    if (mode == "--stream-check") {
+        int fryer = argc > 2 ? std::max(1, std::atoi(argv[2])) - 1 : 0;
+        int numFrames = argc > 3 ? std::max(1, std::atoi(argv[3])) : 600;
+        StreamCheckReport report = checkStateStream(fryer, numFrames);
+        printf("%s", formatStreamCheck(report).c_str());
+        return report.withinQuantization ? 0 : 1;
+    }
+
+    if (mode == "--scenarios") {
+        int numFryers = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000;
+        float hours = argc > 3 ? std::max(0.01f, (float)std::atof(argv[3]))
+                               : 1.0f;
+        float endTime = hours * 3600.0f;
+
+        // Even fryers lift on the clock, odd ones at DONE; set points and
+        // basket sizes vary so every fryer recovers on its own schedule
+        ScenarioRunner runner;
+        std::vector<std::vector<LiftedBasket>> lifted(numFryers);
+        for (int i = 0; i < numFryers; i++) {
+            FryerDayConfig config;
+            config.setPoint = 176.0f + i % 10;
+            config.basketMass = 0.4f + 0.4f * (i % 7) / 6.0f;
+            ScenarioContext& fryer = runner.addFryer(config);
+            if (i % 2 == 0) {
+                runner.start(fryer, timedBaskets(fryer, 30.0f, 180.0f, 175.0f,
+                                                 endTime, &lifted[i]));
+            } else {
+                runner.start(fryer, doneBaskets(fryer, 30.0f, 175.0f, endTime,
+                                                &lifted[i]));
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        runner.runUntil(endTime, 0.25f);
+        float seconds = std::chrono::duration<float>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+        int baskets[2] = {0, 0}, done[2] = {0, 0};
+        float cookTime[2] = {0.0f, 0.0f};
+        for (int i = 0; i < numFryers; i++) {
+            for (const LiftedBasket& basket : lifted[i]) {
+                baskets[i % 2]++;
+                done[i % 2] += basket.done;
+                cookTime[i % 2] += basket.cookTime;
+            }
+        }
+        const char* names[2] = {"lift at 180 s", "lift at DONE"};
+        for (int k = 0; k < 2; k++) {
+            printf("%-14s %7d baskets  %5.1f%% done at lift  mean cook "
+                   "%.1f s\n",
+                   names[k], baskets[k],
+                   100.0f * done[k] / std::max(1, baskets[k]),
+                   cookTime[k] / std::max(1, baskets[k]));
+        }
+        printf("%d fryers x %.2f h in %.2f s (%.0fx real time per fryer), "
+               "%ld scenario resumes\n",
+               numFryers, hours, seconds, endTime / seconds,
+               runner.getNumResumes());
+        return 0;
+    }
+
+    if (mode == "--scenario") {
+        if (argc < 3) {
+            fprintf(stderr, "usage: --scenario <file> [runs] [csv]\n");
+            return 1;
+        }
+        ScenarioFile file;
+        std::string error;
+        if (!file.load(argv[2], error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        int runs = argc > 3 ? std::max(1, std::atoi(argv[3])) : 1;
+        std::string output = argc > 4 ? argv[4] : file.name + ".csv";
+
+        // Rows are kept per run so each run's are contiguous in the CSV
+        ScenarioRunner runner;
+        std::vector<std::string> csv(runs);
+        std::vector<LiftedBasket> lifted;
+        for (int run = 0; run < runs; run++) {
+            ScenarioContext& fryer = runner.addFryer(file.fryer);
+            file.prepare(fryer.fryer, run);
+            runner.start(fryer,
+                         playScenarioFile(fryer, file, &csv[run], &lifted));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        runner.runUntil(file.duration, 0.25f);
+        float seconds = std::chrono::duration<float>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+        int numDone = 0;
+        float cookedness = 0.0f, moisture = 0.0f, crust = 0.0f;
+        for (const LiftedBasket& basket : lifted) {
+            numDone += basket.done;
+            cookedness += basket.cookedness / lifted.size();
+            moisture += basket.moisture / lifted.size();
+            crust += basket.crust / lifted.size();
+        }
+        printf("%s: %d runs x %.0f s in %.2f s, %zu baskets lifted "
+               "(%d done), mean cookedness %.3f moisture %.3f crust %.3f\n",
+               file.name.c_str(), runs, file.duration, seconds, lifted.size(),
+               numDone, cookedness, moisture, crust);
+
+        if (!file.outputs.empty()) {
+            FILE* out = fopen(output.c_str(), "w");
+            if (out == nullptr) return 1;
+            fputs(file.formatHeader().c_str(), out);
+            for (const std::string& rows : csv) {
+                fwrite(rows.data(), 1, rows.size(), out);
+            }
+            fclose(out);
+            printf("recorded %s -> %s\n", file.name.c_str(), output.c_str());
+        }
+        return 0;
+    }
+
+    if (mode == "--job-server") {
+        std::string path = argc > 2 ? argv[2] : JobServer::getDefaultPath();
+        JobServer server(path);
+        if (!server.start()) return 1;
+        std::signal(SIGINT, onStopSignal);
+        std::signal(SIGTERM, onStopSignal);
+        server.run([] { return stopSignalled != 0; });
+        return 0;
+    }
+
+    if (mode == "--job") {
+        if (argc < 3) {
+            fprintf(stderr, "usage: --job <json> [path]\n");
+            return 1;
+        }
+        std::string path = argc > 3 ? argv[3] : JobServer::getDefaultPath();
+        if (!runJobClient(path, argv[2])) {
+            fprintf(stderr, "cannot reach job server at %s\n", path.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+    if (mode == "--twin") {
+        std::string source = argc > 2 ? argv[2] : "udp:8790";
+        SensorFeed feed;
+        if (!feed.open(source)) return 1;
+        std::signal(SIGINT, onStopSignal);
+        std::signal(SIGTERM, onStopSignal);
+
+        DigitalTwin twin;
+        std::vector<SensorMessage> messages;
+        while (!stopSignalled) {
+            messages.clear();
+            feed.poll(100, messages);
+            for (const SensorMessage& message : messages) {
+                auto start = std::chrono::steady_clock::now();
+                twin.apply(message);
+                float ms = std::chrono::duration<float, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+                if (message.type == SensorMessage::SAMPLE) {
+                    printf("t %8.1f  oil %6.1f C", twin.time,
+                           twin.oilTemperature);
+                    for (const auto& basket : twin.baskets) {
+                        if (basket->doneTime >= 0.0f) {
+                            printf("  basket %d: DONE at %.1f", basket->id,
+                                   basket->doneTime);
+                        } else if (basket->predictedDone < 0.0f) {
+                            printf("  basket %d: not done in %.0f s",
+                                   basket->id, twin.horizon);
+                        } else {
+                            printf("  basket %d: done at %.1f (%+.1f s)",
+                                   basket->id, basket->predictedDone,
+                                   basket->predictedDone - twin.time);
+                        }
+                    }
+                    printf("  [%.2f ms]\n", ms);
+                } else if (message.type == SensorMessage::LIFT) {
+                    const TwinBasket* basket = twin.findBasket(message.basket);
+                    if (basket == nullptr) continue;
+                    if (basket->doneTime < 0.0f) {
+                        printf("basket %d lifted at %.1f before DONE\n",
+                               basket->id, message.time);
+                        continue;
+                    }
+                    printf("basket %d lifted at %.1f, DONE at %.1f; forecast "
+                           "error",
+                           basket->id, message.time, basket->doneTime);
+                    for (int i = 0; i < TwinBasket::NUM_LEADS; i++) {
+                        float error = basket->leadErrors[i];
+                        if (std::isnan(error)) continue;
+                        printf("  %.0f s ahead %+.1f s",
+                               TwinBasket::LEAD_TIMES[i], error);
+                    }
+                    printf("\n");
+                }
+            }
+            fflush(stdout);
+        }
+        if (feed.numMalformed > 0) {
+            fprintf(stderr, "%d malformed sensor lines skipped\n",
+                    feed.numMalformed);
+        }
+        return 0;
+    }
+
+    if (mode == "--replay-sensor") {
+        if (argc < 3) {
+            fprintf(stderr, "usage: --replay-sensor <log> [target] [speed]\n");
+            return 1;
+        }
+        std::string target = argc > 3 ? argv[3] : "udp:8790";
+        float speed = argc > 4 ? std::max(0.01f, (float)std::atof(argv[4]))
+                               : 1.0f;
+        return replaySensorLog(argv[2], target, speed) ? 0 : 1;
+    }
+
+    if (mode == "--validate-log") {
+        if (argc < 3) {
+            fprintf(stderr, "usage: --validate-log <log>\n");
+            return 1;
+        }
+        FryerLog log;
+        if (!log.open(argv[2])) return 1;
+        WorkerPool pool;
+        LogValidationReport report = validateFryerLog(log, pool);
+        printf("%s", formatLogValidation(report).c_str());
+        return report.numBaskets > 0 ? 0 : 1;
+    }
+
+    if (mode == "--convert-log") {
+        if (argc < 4) {
+            fprintf(stderr, "usage: --convert-log <log> <out>\n");
+            return 1;
+        }
+        FryerLog log;
+        if (!log.open(argv[2]) || !log.writeBinary(argv[3])) return 1;
+        return 0;
+    }
+
+    if (mode == "--view") {
+        int fryer = argc > 2 ? std::max(1, std::atoi(argv[2])) - 1 : 0;
+        ofSetupOpenGL(1024, 768, OF_WINDOW);
+        ofRunApp(new ofApp(ofApp::RUN_VIEW, fryer));
+        return 0;
+    }
+
+    if (mode == "--play") {
+        if (argc < 3) {
+            fprintf(stderr, "usage: --play <file>\n");
+            return 1;
+        }
+        ofSetupOpenGL(1024, 768, OF_WINDOW);
+        ofRunApp(new ofApp(ofApp::RUN_LOCAL, 0, false, argv[2]));
+        return 0;
+    }
+
+    if (mode == "--replay-log") {
+        if (argc < 3) {
+            fprintf(stderr, "usage: --replay-log <log>\n");
+            return 1;
+        }
+        ofSetupOpenGL(1024, 768, OF_WINDOW);
+        ofRunApp(new ofApp(ofApp::RUN_LOCAL, 0, false, "", argv[2]));
+        return 0;
+    }
+
+    if (mode == "--record-input" || mode == "--replay-input") {
+        if (argc < 3) {
+            fprintf(stderr, "usage: %s <file>\n", mode.c_str());
+            return 1;
+        }
+        bool record = mode == "--record-input";
+        ofSetupOpenGL(1024, 768, OF_WINDOW);
+        ofRunApp(new ofApp(ofApp::RUN_LOCAL, 0, false, "", "",
+                           record ? argv[2] : "", record ? "" : argv[2]));
+        return 0;
+    }
+
     ofSetupOpenGL(1024, 768, OF_WINDOW);
     ofRunApp(new ofApp());
 }
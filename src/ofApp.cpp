@@ -3,9 +3,128 @@
 #include <algorithm>
 #include <cmath>
 
+// Desktop windows can be asked for the cursor directly at draw time
+#if !defined(TARGET_OF_IOS) && !defined(TARGET_ANDROID) && \
+    !defined(TARGET_EMSCRIPTEN) && !defined(TARGET_RASPBERRY_PI_LEGACY)
+#define HAS_GLFW_CURSOR
+#include "GLFW/glfw3.h"
+#endif
+
+namespace {
+
+// Weight of the newest frame in the profiler's running averages
+const float PROFILER_SMOOTHING = 0.1f;
+
+static_assert(FrameSnapshot::PERIMETER_SEGMENTS == Potato::PERIMETER_SEGMENTS,
+              "frame layout must match the fry perimeter");
+
+uint32_t packColor(const ofColor& c) {
+    return ((uint32_t)c.r << 24) | ((uint32_t)c.g << 16) |
+           ((uint32_t)c.b << 8) | (uint32_t)c.a;
+}
+
+ofColor unpackColor(uint32_t packed) {
+    return ofColor((packed >> 24) & 0xff, (packed >> 16) & 0xff,
+                   (packed >> 8) & 0xff, packed & 0xff);
+}
+
+void writeFry(FrameSnapshot& frame, int i, const Potato& fry) {
+    frame.fryX[i] = fry.position.x;
+    frame.fryY[i] = fry.position.y;
+    frame.fryWidth[i] = fry.size.x;
+    frame.fryHeight[i] = fry.size.y;
+    frame.fryTemperature[i] = fry.temperature;
+    frame.fryDensity[i] = fry.density;
+    frame.fryMoisture[i] = fry.moistureContent;
+    frame.fryCookedness[i] = fry.cookedness;
+    frame.fryCrust[i] = fry.crustThickness;
+    frame.fryTimeInOil[i] = fry.timeInOil;
+    frame.frySurfaceTemperature[i] = fry.getSurfaceTemperature();
+    frame.fryCoreTemperature[i] = fry.getCoreTemperature();
+    frame.fryColor[i] = packColor(fry.currentColor);
+    frame.fryInOilFlag[i] = fry.isInOil;
+    frame.fryResolved[i] = fry.resolved;
+    for (int k = 0; k < Potato::PERIMETER_SEGMENTS; k++) {
+        frame.segmentCrust[k][i] = fry.segmentCrust[k];
+    }
+}
+
+// Overwrites the drawn state of a viewer-side fry; the perimeter depends
+// only on size, so the fry is rebuilt only when that changes
+void readFry(const FrameSnapshot& frame, int i, Potato& fry) {
+    ofVec2f position(frame.fryX[i], frame.fryY[i]);
+    ofVec2f size(frame.fryWidth[i], frame.fryHeight[i]);
+    if (fry.size != size) fry = Potato(position, size, i);
+
+    fry.position = position;
+    fry.temperature = frame.fryTemperature[i];
+    fry.density = frame.fryDensity[i];
+    fry.moistureContent = frame.fryMoisture[i];
+    fry.cookedness = frame.fryCookedness[i];
+    fry.crustThickness = frame.fryCrust[i];
+    fry.timeInOil = frame.fryTimeInOil[i];
+    fry.currentColor = unpackColor(frame.fryColor[i]);
+    fry.isInOil = frame.fryInOilFlag[i];
+    fry.resolved = frame.fryResolved[i];
+    fry.nodeTemperatures[0] = frame.frySurfaceTemperature[i];
+    fry.nodeTemperatures[Potato::CONDUCTION_NODES - 1] =
+        frame.fryCoreTemperature[i];
+    for (int k = 0; k < Potato::PERIMETER_SEGMENTS; k++) {
+        fry.segmentCrust[k] = frame.segmentCrust[k][i];
+    }
+}
+
+}  // namespace
+
+ofApp::ofApp(RunMode mode, int fryer, bool startWithBasket,
+             const std::string& scenarioPath, const std::string& oilLogPath,
+             const std::string& inputRecordPath,
+             const std::string& inputReplayPath)
+    : inputRecordPath(inputRecordPath),
+      inputReplayPath(inputReplayPath),
+      inputRecord(nullptr),
+      inputReplay(nullptr),
+      hasNextReplayed(false),
+      runMode(mode),
+      fryerIndex(fryer),
+      startWithBasket(startWithBasket),
+      frameRing(nullptr),
+      viewFrame(nullptr),
+      viewSequence(0),
+      viewStaleTime(0),
+      scenarioPath(scenarioPath),
+      scenario(nullptr),
+      scenarioStep(0),
+      scenarioStartTime(0),
+      oilLogPath(oilLogPath),
+      oilLog(nullptr),
+      oilLogCursor(nullptr),
+      oilLogTime(0),
+      oilLogBasketIn(false),
+      dashboardServer(nullptr),
+      stateEncoder(nullptr) {}
+
 ofApp::~ofApp() {
+    // Stop the audio thread before the synth it reads from goes away
+    soundStream.close();
+    delete fryingSound;
     delete oilSurface;
+    delete surfaceWaves;
+    delete bubbleField;
+    delete steam;
+    delete splatter;
+    delete oilController;
     delete potatoFry;
+    delete fryGrid;
+    delete frameRing;
+    delete viewFrame;
+    delete scenario;
+    delete oilLogCursor;
+    delete oilLog;
+    delete inputRecord;
+    delete inputReplay;
+    delete dashboardServer;
+    delete stateEncoder;
 }
 
 void ofApp::setup() {
@@ -30,136 +149,1032 @@ void ofApp::setup() {
 
     oilTemperature = 175.0f;
     targetTemperature = 175.0f;
-    updateOilViscosity();
 
     oilSurface = new Oil(oilTopY, oilTemperature);
+    surfaceWaves = new SurfaceWaves(fryerLeftX + 15, fryerRightX - 15);
+    bubbleField = new VoidFractionField(fryerLeftX + 15, oilTopY,
+                                        fryerRightX - 15, oilBottomY);
+    fieldPopCarry.assign(bubbleField->cols, 0.0f);
+    steam = new ParticlePool(STEAM_BUDGET);
+    splatter = new ParticlePool(SPLATTER_BUDGET);
+    updateOilViscosity();
+    oilController = new OilController();
+    mpcEnabled = false;
+    controlTimer = 0;
+    pendingWaterReleased = 0;
     elapsedTime = 0;
+
+    // Fries and oil temperature at 60 Hz, bubbles sub-cycled within each
+    // fry step, oil chemistry once per simulated second
+    fryRate = scheduler.addRate(1.0f / 60.0f, 6);
+    chemistryRate = scheduler.addRate(1.0f, 1);
     potatoFry = nullptr;
     fryInOil = false;
+    fryGrid = new FryGrid(0, 0, screenWidth, screenHeight);
+    selecting = false;
     currentDraggedFry = nullptr;
+    inspectedFry = nullptr;
     isPaused = false;
-}
+    droppedInputs = 0;
+    fryStepCount = 0;
+    lateLatch = true;
+    latestPointerTime = 0;
+    shownPointerTime = 0;
+    newPointerSample = false;
+    showProfiler = false;
+    frameStartTime = ofGetElapsedTimef();
+    updateMillis = 0;
+    drawMillis = 0;
+    inputLatencyMillis = 0;
+    std::fill(fryEventTimes, fryEventTimes + 3, -1.0f);
+    simSeed = std::random_device()();
+    simRng.seed(simSeed);
+
+    // Bubble sound on its own audio thread, fed from updatePhysics
+    ofSoundStreamSettings soundSettings;
+    soundSettings.sampleRate = 48000;
+    soundSettings.numOutputChannels = 2;
+    soundSettings.numInputChannels = 0;
+    soundSettings.bufferSize = 256;
+    soundSettings.setOutListener(this);
+    fryingSound = new FryingSound(soundSettings.sampleRate);
+    soundEnabled = runMode == RUN_LOCAL;
+    if (soundEnabled) soundStream.setup(soundSettings);
+
+    frameRing = new FrameRing();
+    if (runMode == RUN_PUBLISH) {
+        frameRing->create(FrameRing::getName(fryerIndex));
+        dashboardServer = new WebSocketServer(DASHBOARD_BASE_PORT + fryerIndex);
+        dashboardServer->start();
+        stateEncoder = new StateEncoder();
+        applyKey(startWithBasket ? 'b' : ' ');
+    } else if (runMode == RUN_VIEW) {
+        viewFrame = new FrameSnapshot();
+        attachViewer(fryerIndex);
+    }
 
-void ofApp::updateOilViscosity() {
-    // Arrhenius viscosity model [4]
-    // μ = A * exp(Ea/RT), non-linear temperature dependence
-    float T_Kelvin = oilTemperature + 273.15f;
-    float viscosity_inf = 0.00001f;
-    float Ea_R = 2500.0f;
-    oilViscosity = viscosity_inf * exp(Ea_R / T_Kelvin);
-    oilViscosity = ofClamp(oilViscosity, 0.003f, 0.030f);
-}
+    // A recording starts with the seed of every simulation draw, so its
+    // replay reproduces the session and not just the input
+    if (runMode == RUN_LOCAL && !inputReplayPath.empty()) {
+        inputReplay = new std::ifstream(inputReplayPath);
+        std::string word;
+        if (!*inputReplay) {
+            ofLogError("ofApp") << "cannot open " << inputReplayPath;
+            delete inputReplay;
+            inputReplay = nullptr;
+        } else if (!(*inputReplay >> word >> simSeed) || word != "seed") {
+            ofLogError("ofApp") << inputReplayPath << " has no seed";
+            delete inputReplay;
+            inputReplay = nullptr;
+        } else {
+            simRng.seed(simSeed);
+        }
+    } else if (runMode == RUN_LOCAL && !inputRecordPath.empty()) {
+        inputRecord = new std::ofstream(inputRecordPath);
+        if (!*inputRecord) {
+            ofLogError("ofApp") << "cannot write " << inputRecordPath;
+            delete inputRecord;
+            inputRecord = nullptr;
+        } else {
+            *inputRecord << "seed " << simSeed << '\n';
+        }
+    }
+
+    if (runMode == RUN_LOCAL && !scenarioPath.empty()) {
+        scenario = new ScenarioFile();
+        std::string error;
+        if (scenario->load(scenarioPath, error)) {
+            startScenario();
+        } else {
+            ofLogError("ofApp") << error;
+            delete scenario;
+            scenario = nullptr;
+        }
+    }
 
-float ofApp::getOilDensity() {
-    // Linear thermal expansion model [4]
-    // ρ(T) = ρ₀ - α(T - T₀), where ρ₀ = 0.915 g/cm³ at T₀ = 20°C
-    // Result: ~0.825 g/cm³ at 160°C, ~0.806 g/cm³ at 190°C
-    return 0.915f - 0.00064f * (oilTemperature - 20.0f);
+    if (runMode == RUN_LOCAL && !oilLogPath.empty()) {
+        oilLog = new FryerLog();
+        if (oilLog->open(oilLogPath)) {
+            startOilLog();
+        } else {
+            delete oilLog;
+            oilLog = nullptr;
+        }
+    }
 }
 
+void ofApp::updateOilViscosity() { oilViscosity = oilSurface->getViscosity(); }
+
+float ofApp::getOilDensity() { return oilSurface->getDensity(); }
+
 void ofApp::update() {
+    frameStartTime = ofGetElapsedTimef();
+
+    // Input is applied at the frame boundary, before any stepping; pause
+    // itself arrives this way, so drain before checking it
+    processInput();
+
+    if (runMode == RUN_VIEW) {
+        updateViewer();
+        return;
+    }
+
     // Skip all updates when paused
     if (isPaused) return;
 
     float deltaTime = ofClamp(ofGetLastFrameTime(), 0, 0.1f);
     elapsedTime += deltaTime;
 
-    // Temperature control with exponential smoothing
-    oilTemperature += (targetTemperature - oilTemperature) * 0.05f;
-    oilTemperature = ofClamp(oilTemperature, 160.0f, 190.0f);
-    oilSurface->temperature = oilTemperature;
+    scheduler.advance(deltaTime);
+    if (scenario != nullptr) playScenario();
+
+    int frySteps = scheduler.getStepsDue(fryRate);
+    float fryStep = scheduler.getStepSize(fryRate);
+    for (int i = 0; i < frySteps; i++) {
+        if (inputReplay != nullptr) replayInput();
+        stepFries(fryStep);
+        fryStepCount++;
+    }
+
+    // Oil chemistry changes over hours; step it on its own slow clock with
+    // the water released since the last chemistry step
+    int chemistrySteps = scheduler.getStepsDue(chemistryRate);
+    for (int i = 0; i < chemistrySteps; i++) {
+        oilSurface->degrade(scheduler.getStepSize(chemistryRate),
+                            pendingWaterReleased);
+        pendingWaterReleased = 0;
+    }
+
+    // Remove dead particles
+    particles.erase(std::remove_if(particles.begin(), particles.end(),
+                                   [](Bubble& p) { return p.isDead; }),
+                    particles.end());
+
+    if (runMode == RUN_PUBLISH) publishFrame();
+}
+
+void ofApp::publishFrame() {
+    FrameSnapshot* frame = frameRing->beginWrite();
+    if (frame == nullptr) return;
+
+    frame->simTime = elapsedTime;
+    frame->oilTemperature = oilTemperature;
+    frame->targetTemperature = targetTemperature;
+    frame->polarCompounds = oilSurface->polarCompounds;
+    std::copy(fryEventTimes, fryEventTimes + 3, frame->fryEventTimes);
+    frame->mpcEnabled = mpcEnabled;
+    frame->isPaused = isPaused;
+    frame->hasSingleFry = potatoFry != nullptr;
+    frame->fryInOil = fryInOil;
+
+    int numFries = 0;
+    if (potatoFry != nullptr) writeFry(*frame, numFries++, *potatoFry);
+    for (const auto& fry : basketFries) {
+        if (numFries == FrameSnapshot::MAX_FRIES) break;
+        writeFry(*frame, numFries++, fry);
+    }
+    frame->numFries = numFries;
+
+    int numBubbles =
+        std::min((int)particles.size(), FrameSnapshot::MAX_BUBBLES);
+    for (int i = 0; i < numBubbles; i++) {
+        const Bubble& p = particles[i];
+        frame->bubbleId[i] = p.id;
+        frame->bubbleX[i] = p.position.x;
+        frame->bubbleY[i] = p.position.y;
+        frame->bubbleVx[i] = p.velocity.x;
+        frame->bubbleVy[i] = p.velocity.y;
+        frame->bubbleSize[i] = p.size;
+        frame->bubbleLife[i] = p.life;
+        frame->bubbleWobble[i] = p.wobblePhase;
+        frame->bubbleColor[i] = packColor(p.color);
+        frame->bubbleType[i] = p.bubbleType;
+        frame->bubbleSurfaced[i] = p.reachedSurface;
+    }
+    frame->numBubbles = numBubbles;
+
+    int numSteam = std::min(steam->count, FrameSnapshot::MAX_STEAM);
+    std::copy(steam->x.begin(), steam->x.begin() + numSteam, frame->steamX);
+    std::copy(steam->y.begin(), steam->y.begin() + numSteam, frame->steamY);
+    std::copy(steam->size.begin(), steam->size.begin() + numSteam,
+              frame->steamSize);
+    std::copy(steam->age.begin(), steam->age.begin() + numSteam,
+              frame->steamAge);
+    std::copy(steam->lifespan.begin(), steam->lifespan.begin() + numSteam,
+              frame->steamLifespan);
+    frame->numSteam = numSteam;
+
+    int numSplatter = std::min(splatter->count, FrameSnapshot::MAX_SPLATTER);
+    std::copy(splatter->x.begin(), splatter->x.begin() + numSplatter,
+              frame->splatterX);
+    std::copy(splatter->y.begin(), splatter->y.begin() + numSplatter,
+              frame->splatterY);
+    std::copy(splatter->size.begin(), splatter->size.begin() + numSplatter,
+              frame->splatterSize);
+    frame->numSplatter = numSplatter;
+
+    const std::vector<float>& density = bubbleField->getDensity();
+    int numCells =
+        std::min((int)density.size(), FrameSnapshot::MAX_FIELD_CELLS);
+    std::copy(density.begin(), density.begin() + numCells,
+              frame->fieldDensity);
+    frame->numFieldCells = numCells;
+
+    const std::vector<float>& heights = surfaceWaves->getHeights();
+    int numWaveCells =
+        std::min((int)heights.size(), FrameSnapshot::MAX_WAVE_CELLS);
+    std::copy(heights.begin(), heights.begin() + numWaveCells,
+              frame->waveHeight);
+    frame->numWaveCells = numWaveCells;
+
+    frameRing->endWrite();
+    streamFrame(*frame);
+}
+
+void ofApp::streamFrame(const FrameSnapshot& frame) {
+    dashboardServer->poll();
+
+    // With nobody watching, drop the delta reference so the next client
+    // starts from a keyframe
+    if (dashboardServer->getNumClients() == 0) {
+        stateEncoder->reset();
+        return;
+    }
+
+    // Stream frame numbers are ring sequence numbers, so a client can match
+    // a decoded frame against the shared-memory copy
+    bool keyframe;
+    const std::string& message = stateEncoder->encode(
+        frame, frameRing->getLatestSequence(), keyframe);
+    dashboardServer->broadcast(message, keyframe);
+}
+
+void ofApp::attachViewer(int fryer) {
+    fryerIndex = fryer;
+    frameRing->attach(FrameRing::getName(fryer));
+    viewSequence = 0;
+    viewStaleTime = 0;
+}
+
+void ofApp::updateViewer() {
+    // Publisher not up yet, or gone quiet (exited or restarted under the
+    // same name): keep showing the last frame and re-attach periodically
+    viewStaleTime += ofGetLastFrameTime();
+    if (!frameRing->isOpen() || viewStaleTime > VIEW_STALE_TIMEOUT) {
+        attachViewer(fryerIndex);
+    }
+
+    uint64_t sequence = frameRing->readLatest(*viewFrame);
+    if (sequence != 0 && sequence != viewSequence) {
+        viewSequence = sequence;
+        viewStaleTime = 0;
+        applyFrame(*viewFrame);
+        updateFryGrid();
+    }
+    inspectedFry = findFryAt(mousePosition);
+}
+
+void ofApp::applyFrame(const FrameSnapshot& frame) {
+    elapsedTime = frame.simTime;
+    oilTemperature = frame.oilTemperature;
+    oilSurface->temperature = frame.oilTemperature;
+    targetTemperature = frame.targetTemperature;
+    oilSurface->polarCompounds = frame.polarCompounds;
+    std::copy(frame.fryEventTimes, frame.fryEventTimes + 3, fryEventTimes);
+    mpcEnabled = frame.mpcEnabled;
+    isPaused = frame.isPaused;
+    fryInOil = frame.fryInOil;
+    updateOilViscosity();
+
+    // Fries: mirror objects persist while the roster keeps its shape
+    int first = frame.hasSingleFry ? 1 : 0;
+    if (frame.hasSingleFry) {
+        if (potatoFry == nullptr) {
+            potatoFry = new Potato(ofVec2f(frame.fryX[0], frame.fryY[0]),
+                                   ofVec2f(frame.fryWidth[0],
+                                           frame.fryHeight[0]),
+                                   0);
+        }
+        readFry(frame, 0, *potatoFry);
+    } else if (potatoFry != nullptr) {
+        delete potatoFry;
+        potatoFry = nullptr;
+    }
+
+    int numBasket = std::max(0, frame.numFries - first);
+    if ((int)basketFries.size() != numBasket) {
+        basketFries.clear();
+        for (int i = 0; i < numBasket; i++) {
+            basketFries.push_back(
+                Potato(ofVec2f(frame.fryX[first + i], frame.fryY[first + i]),
+                       ofVec2f(frame.fryWidth[first + i],
+                               frame.fryHeight[first + i]),
+                       first + i));
+        }
+    }
+    for (int i = 0; i < numBasket; i++) {
+        readFry(frame, first + i, basketFries[i]);
+    }
+
+    // Bubbles: grow the pool with placeholders, then overwrite in place;
+    // trails are not published
+    while ((int)particles.size() < frame.numBubbles) {
+        particles.push_back(
+            Bubble(ofVec2f(), oilTemperature, 0, oilTopY, simRng));
+    }
+    particles.erase(particles.begin() + frame.numBubbles, particles.end());
+    for (int i = 0; i < frame.numBubbles; i++) {
+        Bubble& p = particles[i];
+        p.id = frame.bubbleId[i];
+        p.position.set(frame.bubbleX[i], frame.bubbleY[i]);
+        p.velocity.set(frame.bubbleVx[i], frame.bubbleVy[i]);
+        p.size = frame.bubbleSize[i];
+        p.life = frame.bubbleLife[i];
+        p.wobblePhase = frame.bubbleWobble[i];
+        p.color = unpackColor(frame.bubbleColor[i]);
+        p.bubbleType = frame.bubbleType[i];
+        p.reachedSurface = frame.bubbleSurfaced[i];
+        p.isDead = false;
+        p.trail.clear();
+    }
+
+    steam->count = std::min(frame.numSteam, steam->getCapacity());
+    std::copy(frame.steamX, frame.steamX + steam->count, steam->x.begin());
+    std::copy(frame.steamY, frame.steamY + steam->count, steam->y.begin());
+    std::copy(frame.steamSize, frame.steamSize + steam->count,
+              steam->size.begin());
+    std::copy(frame.steamAge, frame.steamAge + steam->count,
+              steam->age.begin());
+    std::copy(frame.steamLifespan, frame.steamLifespan + steam->count,
+              steam->lifespan.begin());
+
+    splatter->count = std::min(frame.numSplatter, splatter->getCapacity());
+    std::copy(frame.splatterX, frame.splatterX + splatter->count,
+              splatter->x.begin());
+    std::copy(frame.splatterY, frame.splatterY + splatter->count,
+              splatter->y.begin());
+    std::copy(frame.splatterSize, frame.splatterSize + splatter->count,
+              splatter->size.begin());
+
+    bubbleField->setDensity(frame.fieldDensity, frame.numFieldCells);
+    surfaceWaves->setHeights(frame.waveHeight, frame.numWaveCells);
+}
+
+void ofApp::stepFries(float dt) {
+    // Model-predictive set point, re-planned every control interval off
+    // this thread and applied at the first step after the plan finishes.
+    // That step depends on the wall clock, so the applied set point is
+    // recorded like input and a replay applies it instead of re-planning.
+    if (mpcEnabled && potatoFry != nullptr && fryInOil &&
+        inputReplay == nullptr) {
+        float planned;
+        if (oilController->poll(planned)) {
+            InputEvent event = {};
+            event.type = InputEvent::SET_POINT;
+            event.x = planned;
+            event.step = fryStepCount;
+            applyInput(event);
+            recordInput(event);
+        }
+        controlTimer -= dt;
+        if (controlTimer <= 0) {
+            controlTimer += oilController->controlInterval;
+            oilController->request(*potatoFry, *oilSurface, targetTemperature,
+                                   basketBottomY);
+        }
+    }
+
+    // Temperature control with exponential smoothing, unless a log is
+    // imposing the oil temperature. A scenario's fryer instead has the
+    // file's heater power and oil heat capacity, as in its headless runs:
+    // the fries draw their heat from the oil and the thermostat refills it.
+    bool heatBalance = scenario != nullptr && oilLog == nullptr;
+    float startViscosity = oilViscosity;
+    if (oilLog != nullptr) {
+        stepOilLog(dt);
+    } else if (!heatBalance) {
+        oilSurface->approachTarget(targetTemperature, dt);
+    }
+    oilTemperature = oilSurface->temperature;
 
     updateOilViscosity();
 
     // Fry physics update
+    float oilDensity = getOilDensity();
+    updateFryLod();
+
+    float load = 0.0f;
     if (potatoFry != nullptr && fryInOil) {
-        float oilDensity = getOilDensity();
-        potatoFry->update(deltaTime, oilTemperature, oilTopY, oilDensity,
-                          basketBottomY);
+        load += stepFry(*potatoFry, dt, oilDensity, FRY_MASS);
+        spawnBubblesForFry(*potatoFry, dt);
+    }
 
-        // Override movement when dragging
-        if (currentDraggedFry != nullptr) {
+    // Basket fries stay lumped unless inspected; away from the cursor their
+    // bubbles go to the void-fraction field. In a scenario they share its
+    // basket mass by cut area.
+    float basketArea = 0.0f;
+    for (const auto& fry : basketFries) basketArea += fry.size.x * fry.size.y;
+    for (auto& fry : basketFries) {
+        float mass = FRY_MASS;
+        if (scenario != nullptr) {
+            mass = scenario->fryer.basketMass * fry.size.x * fry.size.y /
+                   basketArea;
+        }
+        load += stepFry(fry, dt, oilDensity, mass);
+        spawnBubblesForFry(fry, dt);
+    }
+
+    if (heatBalance) {
+        FryerDayConfig config = scenario->fryer;
+        config.setPoint = targetTemperature;
+        exchangeOilHeat(*oilSurface, load, config, dt);
+        oilTemperature = oilSurface->temperature;
+    }
+
+    // Override movement when dragging; a selected group keeps its layout
+    // around the fry under the pointer
+    if (currentDraggedFry != nullptr) {
+        ofVec2f delta = dragPosition - currentDraggedFry->position;
+        if (currentDraggedFry->selected) {
+            for (int id : selectedFries) {
+                Potato* fry = getFry(id);
+                if (fry == nullptr || !fry->selected) continue;
+                fry->position += delta;
+                fry->velocity = ofVec2f(0, 0);
+            }
+        } else {
             currentDraggedFry->position = dragPosition;
             currentDraggedFry->velocity = ofVec2f(0, 0);
         }
+    }
 
-        // Bubble generation
-        float bubbleGenerationFactor =
-            potatoFry->getBubbleGenerationFactor(oilTemperature);
+    surfaceWaves->update(dt);
+
+    // Steam: buoyant, strongly damped; splatter: ballistic until it falls
+    // back into the oil
+    steam->sway(dt, 6.0f, simRng);
+    steam->integrate(dt, 0, -25.0f, 1.5f);
+    steam->removeExpired();
+    splatter->integrate(dt, 0, 900.0f, 0.3f);
+    splatter->expireFallingBelow(oilTopY);
+    splatter->removeExpired();
+
+    // Bubbles sub-cycled through the fry step, seeing the oil viscosity
+    // interpolated from its start to its end value
+    float bubbleStep = dt / BUBBLE_SUBSTEPS;
+    for (int i = 0; i < BUBBLE_SUBSTEPS; i++) {
+        float fraction =
+            MultirateScheduler::getSubstepFraction(i, BUBBLE_SUBSTEPS);
+        updatePhysics(bubbleStep,
+                      ofLerp(startViscosity, oilViscosity, fraction));
+    }
+    exchangeBubbles();
+    updateBubbleField(dt);
 
-        if (bubbleGenerationFactor > 0.0f) {
-            float minBubblesTarget = 0.5f;
-            float maxBubblesTarget = 20.0f;
-            float targetNumBubbles =
-                ofMap(bubbleGenerationFactor, 0.0f, 1.0f, minBubblesTarget,
-                      maxBubblesTarget, true);
+    oilSurface->update(dt);
 
-            int numBubbles =
-                (int)ofRandom(std::max(0.0f, targetNumBubbles - 3.0f),
-                              targetNumBubbles + 3.0f);
-            numBubbles = ofClamp(numBubbles, 0, (int)maxBubblesTarget);
+    // Picking and level of detail see the fries where this step left them
+    updateFryGrid();
+}
 
-            // Sporadic generation at low rates
-            if (numBubbles < 2 &&
-                ofRandom(1.0f) > bubbleGenerationFactor * 8.0f) {
-                numBubbles = 0;
-            }
+float ofApp::getDiscreteFraction(ofVec2f position, float depthBelowSurface) {
+    // Bubbles near the cursor (where the viewer looks) and large ones stay
+    // particles, within the particle budget
+    if ((int)particles.size() >= DISCRETE_BUBBLE_BUDGET) return 0.0f;
+    if (position.distance(mousePosition) < FOCUS_RADIUS) return 1.0f;
+    return Bubble::getLargeFraction(depthBelowSurface, LARGE_BUBBLE_SIZE);
+}
 
-            for (int i = 0; i < numBubbles; i++) {
-                ofVec2f bubblePos = potatoFry->getSurfacePointForBubble();
-                bubblePos.y = ofClamp(bubblePos.y, oilTopY + 5, oilBottomY - 5);
-                float depthBelowSurface = bubblePos.y - oilTopY;
-                spawnBubble(bubblePos, oilTemperature, depthBelowSurface);
-            }
+void ofApp::exchangeBubbles() {
+    // Small particles drifting out of focus hand over to the field (with
+    // hysteresis so they don't flip back and forth at the boundary)
+    for (auto& p : particles) {
+        if (p.isDead || p.reachedSurface || p.startSize >= LARGE_BUBBLE_SIZE) {
+            continue;
+        }
+        if (p.position.distance(mousePosition) > FOCUS_RADIUS * 1.25f) {
+            bubbleField->deposit(p.position.x, p.position.y, 1.0f);
+            p.isDead = true;
         }
     }
 
-    updatePhysics(deltaTime);
-    oilSurface->update(deltaTime);
+    // Field bubbles inside the focus become particles again
+    int room = std::min(MAX_RELEASES_PER_STEP,
+                        DISCRETE_BUBBLE_BUDGET - (int)particles.size());
+    if (room <= 0) return;
+    ofVec2f positions[MAX_RELEASES_PER_STEP];
+    int count = bubbleField->extract(mousePosition.x, mousePosition.y,
+                                     FOCUS_RADIUS, room, positions, simRng);
+    for (int i = 0; i < count; i++) {
+        spawnBubble(positions[i], oilTemperature, positions[i].y - oilTopY);
+    }
+}
 
-    // Remove dead particles
-    particles.erase(std::remove_if(particles.begin(), particles.end(),
-                                   [](Bubble& p) { return p.isDead; }),
-                    particles.end());
+void ofApp::updateBubbleField(float dt) {
+    bubbleField->update(dt, FIELD_RISE_SPEED);
+
+    // Whole bubbles leaving through the surface pop: a few sound events and
+    // one wave impulse per column
+    float oilLeft = fryerLeftX + 15;
+    float oilRight = fryerRightX - 15;
+    for (int c = 0; c < bubbleField->cols; c++) {
+        fieldPopCarry[c] += bubbleField->surfaceOutflow[c];
+        int pops = (int)fieldPopCarry[c];
+        if (pops == 0) continue;
+        fieldPopCarry[c] -= pops;
+
+        float x = bubbleField->getColumnX(c);
+        for (int i = 0; i < std::min(pops, 2); i++) {
+            BubbleSoundEvent event;
+            event.time = elapsedTime;
+            event.bubbleType = 1;
+            event.size = random(2.5f, 4.5f);
+            event.pan = ofMap(x, oilLeft, oilRight, -1, 1, true);
+            fryingSound->post(event);
+        }
+        surfaceWaves->excite(x, -std::min(40.0f, 4.0f * pops), 4.0f);
+    }
+}
+
+float ofApp::stepFry(Potato& fry, float dt, float oilDensity, float mass) {
+    float startTemperature = fry.temperature;
+    float startMoisture = fry.moistureContent;
+    bool wasBelowSurface = fry.position.y > oilTopY;
+    fry.update(dt, oilTemperature, oilTopY, oilDensity, basketBottomY);
+    float waterReleased =
+        mass * std::max(0.0f, startMoisture - fry.moistureContent);
+    pendingWaterReleased += waterReleased;
+    emitSteam(fry, waterReleased * STEAM_PER_KG);
+
+    // Entering fries push the surface down, surfacing ones lift it
+    bool isBelowSurface = fry.position.y > oilTopY;
+    if (isBelowSurface != wasBelowSurface) {
+        float strength = ofClamp(-fry.velocity.y * 0.4f, -150.0f, 150.0f);
+        surfaceWaves->excite(fry.position.x, strength, fry.size.x * 0.3f);
+        if (isBelowSurface) emitSplatter(fry);
+    }
+    return getFryHeatLoad(fry, mass, startTemperature, startMoisture);
+}
+
+float ofApp::random(float low, float high) {
+    return std::uniform_real_distribution<float>(low, high)(simRng);
+}
+
+void ofApp::emitSteam(const Potato& fry, float expectedCount) {
+    // Whole particles plus a random draw for the fractional remainder
+    int numParticles = (int)(expectedCount + random(0.0f, 1.0f));
+    for (int i = 0; i < numParticles; i++) {
+        float x = fry.position.x + random(-0.5f, 0.5f) * fry.size.x;
+        float y = oilTopY - surfaceWaves->getHeight(x) - 2;
+        if (!steam->spawn(x, y, random(-8, 8), random(-70, -40),
+                          random(4, 9), random(1.2f, 2.2f))) {
+            return;
+        }
+    }
+}
+
+void ofApp::emitSplatter(const Potato& fry) {
+    // Surface water flashing to steam throws oil; wetter, faster fries
+    // throw more
+    float impact = ofClamp(fry.velocity.y / 150.0f, 0.0f, 2.0f);
+    int numDroplets = (int)(fry.moistureContent * impact * 25);
+    for (int i = 0; i < numDroplets; i++) {
+        float x = fry.position.x + random(-0.5f, 0.5f) * fry.size.x;
+        if (!splatter->spawn(x, oilTopY - 2, random(-120, 120),
+                             random(-380, -160), random(1.0f, 2.2f),
+                             1.5f)) {
+            return;
+        }
+    }
+}
+
+void ofApp::drawSteam() {
+    for (int i = 0; i < steam->count; i++) {
+        // Expands and fades as it rises and mixes
+        float t = steam->age[i] / steam->lifespan[i];
+        float radius = steam->size[i] * (1.0f + 2.5f * t);
+        float alpha = 45.0f * (1.0f - t) * std::min(1.0f, t * 8.0f);
+        ofSetColor(235, 235, 230, alpha);
+        ofDrawCircle(steam->x[i], steam->y[i], radius);
+    }
+}
+
+void ofApp::drawSplatter() {
+    ofColor color = oilSurface->getTemperatureColor();
+    ofSetColor(color.r, color.g, color.b, 230);
+    for (int i = 0; i < splatter->count; i++) {
+        ofDrawCircle(splatter->x[i], splatter->y[i], splatter->size[i]);
+    }
+}
+
+void ofApp::spawnBubblesForFry(Potato& fry, float dt) {
+    // Each site's expected release count goes straight into the field,
+    // less the fraction that stays discrete. Releases are sampled at the
+    // full rate with sites from the fry's alias table, then thinned to that
+    // fraction of their site (still a Poisson process per site), so only
+    // the discrete ones are built into particles.
+    const int numSites = Potato::PERIMETER_SEGMENTS;
+    float expected = Potato::MAX_BUBBLE_RATE *
+                     fry.getBubbleGenerationFactor(oilTemperature) * dt;
+    if (expected <= 0.0f) return;
+
+    ofVec2f siteCentre[numSites];
+    float discrete[numSites];
+    bool anyDiscrete = false;
+    for (int k = 0; k < numSites; k++) {
+        ofVec2f centre = fry.position + fry.segmentStart[k] +
+                         fry.segmentSpan[k] * 0.5f;
+        centre.y = ofClamp(centre.y, oilTopY + 5, oilBottomY - 5);
+        discrete[k] = getDiscreteFraction(centre, centre.y - oilTopY);
+        bubbleField->deposit(centre.x, centre.y,
+                             expected * fry.siteShare[k] * (1 - discrete[k]));
+        siteCentre[k] = centre;
+        anyDiscrete |= discrete[k] > 0.0f;
+    }
+    if (!anyDiscrete) return;
+
+    float releaseTimes[MAX_RELEASES_PER_STEP];
+    ofVec2f points[MAX_RELEASES_PER_STEP];
+    int sites[MAX_RELEASES_PER_STEP];
+    int numReleases = fry.sampleBubbleReleases(
+        oilTemperature, dt, releaseTimes, MAX_RELEASES_PER_STEP);
+    fry.sampleBubbleSites(numReleases, points, sites);
+    for (int i = 0; i < numReleases; i++) {
+        int k = sites[i];
+        if (fry.random(0.0f, 1.0f) >= discrete[k]) continue;
+        ofVec2f bubblePos = points[i];
+        bubblePos.y = ofClamp(bubblePos.y, oilTopY + 5, oilBottomY - 5);
+
+        if ((int)particles.size() >= DISCRETE_BUBBLE_BUDGET) {
+            bubbleField->deposit(bubblePos.x, bubblePos.y, 1.0f);
+            continue;
+        }
+
+        // Away from the cursor only the large part of the site's bubbles
+        // was kept, as classified at the site's centre
+        bool inFocus = discrete[k] == 1.0f;
+        float depth = (inFocus ? bubblePos.y : siteCentre[k].y) - oilTopY;
+        Bubble bubble(bubblePos, oilTemperature, depth, oilTopY, simRng,
+                      inFocus ? 0.0f : LARGE_BUBBLE_SIZE);
+        bubble.spawnDelay = releaseTimes[i];
+        particles.push_back(bubble);
+    }
+}
+
+Potato* ofApp::findFryAt(ofVec2f point) {
+    // Only the fries sharing the point's grid cell are tested; the highest
+    // id is the one drawn on top
+    Potato* topmost = nullptr;
+    int topmostId = -1;
+    for (int id : fryGrid->getCandidates(point)) {
+        Potato* fry = getFry(id);
+        if (fry == nullptr || id < topmostId) continue;
+        ofVec2f offset = point - fry->position;
+        if (fabs(offset.x) <= fry->size.x / 2.0f + PICK_MARGIN &&
+            fabs(offset.y) <= fry->size.y / 2.0f + PICK_MARGIN) {
+            topmost = fry;
+            topmostId = id;
+        }
+    }
+    return topmost;
+}
+
+Potato* ofApp::getFry(int id) {
+    // Ids can outlive a basket until the next grid rebuild
+    if (id == SINGLE_FRY_ID) return potatoFry;
+    if (id < 0 || id >= (int)basketFries.size()) return nullptr;
+    return &basketFries[id];
 }
 
-void ofApp::updatePhysics(float dt) {
+void ofApp::updateFryGrid() {
+    // Extra slack covers fries moving before the next rebuild
+    float margin = PICK_MARGIN + 8.0f;
+    auto insert = [&](int id, const Potato& fry) {
+        fryGrid->insert(id, ofRectangle(
+                                fry.position.x - fry.size.x / 2.0f - margin,
+                                fry.position.y - fry.size.y / 2.0f - margin,
+                                fry.size.x + 2.0f * margin,
+                                fry.size.y + 2.0f * margin));
+    };
+
+    fryGrid->clear();
+    for (size_t i = 0; i < basketFries.size(); i++) {
+        insert(i, basketFries[i]);
+    }
+    if (potatoFry != nullptr) insert(SINGLE_FRY_ID, *potatoFry);
+}
+
+void ofApp::clearSelection() {
+    for (int id : selectedFries) {
+        Potato* fry = getFry(id);
+        if (fry != nullptr) fry->selected = false;
+    }
+    selectedFries.clear();
+}
+
+void ofApp::selectFriesIn(const ofRectangle& area) {
+    std::vector<int> candidates;
+    fryGrid->getCandidates(area, candidates);
+    for (int id : candidates) {
+        Potato* fry = getFry(id);
+        if (fry == nullptr) continue;
+        ofRectangle bounds(fry->position.x - fry->size.x / 2.0f,
+                           fry->position.y - fry->size.y / 2.0f, fry->size.x,
+                           fry->size.y);
+        if (bounds.intersects(area)) {
+            fry->selected = true;
+            selectedFries.push_back(id);
+        }
+    }
+}
+
+ofRectangle ofApp::getSelectionBand() const {
+    return ofRectangle(std::min(selectionStart.x, mousePosition.x),
+                       std::min(selectionStart.y, mousePosition.y),
+                       fabs(mousePosition.x - selectionStart.x),
+                       fabs(mousePosition.y - selectionStart.y));
+}
+
+void ofApp::updateFryLod() {
+    // Resolved physics only for the fry being inspected or dragged; the
+    // level switch conserves heat, so fries can change level every frame
+    inspectedFry = currentDraggedFry != nullptr ? currentDraggedFry
+                                                : findFryAt(mousePosition);
+
+    if (potatoFry != nullptr) {
+        potatoFry->setResolved(potatoFry == inspectedFry);
+    }
+    for (auto& fry : basketFries) {
+        fry.setResolved(&fry == inspectedFry);
+    }
+}
+
+void ofApp::dropBasket(const BasketContents& contents) {
+    // Raw fries of the given cut sizes spread across the basket
+    clearSelection();
+    basketFries.clear();
+    basketFries.reserve(contents.numFries);
+    for (int i = 0; i < contents.numFries; i++) {
+        ofVec2f fryPos(random(basketLeftX + 50, basketRightX - 50),
+                       oilTopY - random(30, 160));
+        ofVec2f size = contents.sampleSize(simRng);
+        basketFries.push_back(Potato(fryPos, size, simRng()));
+        basketFries.back().velocity = ofVec2f(0, 100.0f);
+    }
+}
+
+void ofApp::removeBasket() {
+    clearSelection();
+    if (currentDraggedFry != potatoFry) currentDraggedFry = nullptr;
+    if (inspectedFry != potatoFry) inspectedFry = nullptr;
+    basketFries.clear();
+}
+
+void ofApp::shakeBasket() {
+    // Jolts the fries up through the oil; they settle back on their own
+    for (auto& fry : basketFries) {
+        if (fry.isInOil) fry.velocity.y -= random(60, 120);
+    }
+}
+
+void ofApp::startScenario() {
+    targetTemperature = scenario->fryer.setPoint;
+    oilSurface->temperature = scenario->oilTemperature;
+    oilSurface->polarCompounds = scenario->fryer.initialPolarCompounds;
+    oilTemperature = oilSurface->temperature;
+    mpcEnabled = false;
+    simRng.seed(scenario->basket.seed);
+
+    scenarioStep = 0;
+    scenarioStartTime = elapsedTime;
+    scenarioCsv = scenario->formatHeader();
+}
+
+void ofApp::playScenario() {
+    // Steps are due at frame boundaries, like input events
+    float time = elapsedTime - scenarioStartTime;
+    const std::vector<ScenarioAction>& timeline = scenario->timeline;
+    while (scenarioStep < timeline.size() &&
+           timeline[scenarioStep].time <= time) {
+        applyScenarioAction(timeline[scenarioStep++]);
+    }
+}
+
+void ofApp::applyScenarioAction(const ScenarioAction& action) {
+    switch (action.type) {
+        case ScenarioAction::DROP:
+            removeBasket();
+            dropBasket(scenario->basket);
+            break;
+        case ScenarioAction::SHAKE:
+            shakeBasket();
+            break;
+        case ScenarioAction::LIFT:
+            removeBasket();
+            break;
+        case ScenarioAction::SET_TEMPERATURE:
+            mpcEnabled = false;
+            targetTemperature = action.value;
+            break;
+        case ScenarioAction::RECORD: {
+            float values[NUM_SCENARIO_OUTPUTS];
+            sampleScenarioOutputs(*oilSurface, targetTemperature,
+                                  basketFries.data(), basketFries.size(),
+                                  values);
+            scenarioCsv += scenario->formatRow(0, action.time, values);
+            break;
+        }
+        case ScenarioAction::END:
+            if (!scenario->outputs.empty()) {
+                std::string path = ofToDataPath(scenario->name + "_viewer.csv");
+                std::ofstream file(path);
+                file << scenarioCsv;
+                ofLogNotice("ofApp") << "scenario recorded to " << path;
+            }
+            break;
+    }
+}
+
+void ofApp::startOilLog() {
+    delete oilLogCursor;
+    oilLogCursor = new FryerLogCursor(*oilLog);
+    oilLogCursor->advance();
+    oilLogTime = oilLogCursor->getCurrent().time;
+    oilLogBasketIn = false;
+    mpcEnabled = false;
+    removeBasket();
+}
+
+void ofApp::stepOilLog(float dt) {
+    // Logged temperature at the middle of the step; past the end of the
+    // log the oil holds its last reading
+    oilSurface->temperature =
+        oilLogCursor->getTemperature(oilLogTime + 0.5f * dt);
+    oilLogTime += dt;
+
+    const LogSample& sample = oilLogCursor->getSampleBefore(oilLogTime);
+    if (sample.setPoint > 0) targetTemperature = sample.setPoint;
+    bool fries = sample.fries > 0 && !oilLogCursor->isAtEnd();
+    if (fries != oilLogBasketIn) {
+        removeBasket();
+        if (fries) {
+            BasketContents contents;
+            contents.numFries = (int)sample.fries;
+            dropBasket(contents);
+        }
+        oilLogBasketIn = fries;
+    }
+}
+
+void ofApp::updatePhysics(float dt, float viscosity) {
     float oilLeft = fryerLeftX + 15;
     float oilRight = fryerRightX - 15;
 
     for (auto& p : particles) {
-        p.update(dt, oilViscosity);
+        // Bubbles pop where the disturbed surface actually is
+        bool wasAtSurface = p.reachedSurface;
+        p.oilSurfaceY = oilTopY - surfaceWaves->getHeight(p.position.x);
+        p.update(dt, viscosity);
 
         // Boundary constraints
         if (p.position.x < oilLeft) p.position.x = oilLeft;
         if (p.position.x > oilRight) p.position.x = oilRight;
+
+        // Each bubble is heard once, as it breaks the surface
+        if (p.reachedSurface && !wasAtSurface) {
+            fryingSound->post(
+                makeBubbleSoundEvent(p, elapsedTime, oilLeft, oilRight));
+            surfaceWaves->excite(p.position.x, -p.size * 6.0f,
+                                 p.size * 1.2f);
+        }
     }
 }
 
+void ofApp::audioOut(ofSoundBuffer& buffer) {
+    fryingSound->render(buffer.getBuffer().data(), buffer.getNumFrames(),
+                        buffer.getNumChannels());
+}
+
 void ofApp::spawnBubble(ofVec2f position, float temperature,
                         float depthBelowSurface) {
     particles.push_back(
-        Bubble(position, temperature, depthBelowSurface, oilTopY));
+        Bubble(position, temperature, depthBelowSurface, oilTopY, simRng));
+}
+
+void ofApp::onFryEvent(const FryEvent& event) {
+    fryEventTimes[event.type] = event.time;
+
+    const char* names[] = {"FLOAT", "DONE", "BUBBLING_END"};
+    ofLogNotice("ofApp") << names[event.type] << " at t="
+                         << ofToString(event.time, 2) << "s";
 }
 
 void ofApp::draw() {
+    if (runMode == RUN_PUBLISH) return;
+
+    float drawStartTime = ofGetElapsedTimef();
+    updateMillis += PROFILER_SMOOTHING *
+                    ((drawStartTime - frameStartTime) * 1000 - updateMillis);
+
+    latchOffset = ofVec2f(0, 0);
+    // A replayed drag follows the recording, not the live pointer
+    if (lateLatch && currentDraggedFry != nullptr && !isPaused &&
+        inputReplay == nullptr) {
+        latchDrag();
+    }
+
     drawBackground();
     drawCountertop();
     drawFryerHousing();
     drawFryerContainer();
     drawOil();
 
+    for (auto& fry : basketFries) {
+        drawFry(fry);
+    }
+
     if (potatoFry != nullptr) {
-        potatoFry->draw();
+        drawFry(*potatoFry);
     }
 
+    if (selecting) {
+        ofRectangle band = getSelectionBand();
+        ofSetColor(255, 230, 120, 40);
+        ofDrawRectangle(band.x, band.y, band.width, band.height);
+        ofNoFill();
+        ofSetColor(255, 230, 120, 200);
+        ofSetLineWidth(1.0f);
+        ofDrawRectangle(band.x, band.y, band.width, band.height);
+        ofFill();
+    }
+
+    bubbleField->draw(ofColor(250, 245, 225, 150));
+
     for (auto& p : particles) {
         p.draw();
     }
 
+    drawSplatter();
+    drawSteam();
+
     drawFryerBasket();
     drawControlPanel();
     drawUI();
+    if (showProfiler) drawProfiler();
+
+    // Measured to the end of draw; the buffer swap and display scan-out
+    // that follow are outside the app's control
+    float drawEndTime = ofGetElapsedTimef();
+    drawMillis += PROFILER_SMOOTHING *
+                  ((drawEndTime - drawStartTime) * 1000 - drawMillis);
+    if (newPointerSample) {
+        float latency = (drawEndTime - shownPointerTime) * 1000;
+        inputLatencyMillis +=
+            PROFILER_SMOOTHING * (latency - inputLatencyMillis);
+        newPointerSample = false;
+    }
+}
+
+void ofApp::drawFry(Potato& fry) {
+    // A dragged group moves as one, so the late-latch offset applies to it
+    bool dragged = &fry == currentDraggedFry ||
+                   (fry.selected && currentDraggedFry != nullptr &&
+                    currentDraggedFry->selected);
+    if (!fry.selected && (!dragged || latchOffset == ofVec2f(0, 0))) {
+        fry.draw();
+        return;
+    }
+
+    ofPushMatrix();
+    if (dragged) ofTranslate(latchOffset);
+    fry.draw();
+    if (fry.selected) {
+        ofNoFill();
+        ofSetColor(255, 230, 120, 220);
+        ofSetLineWidth(1.5f);
+        ofDrawRectangle(fry.position.x - fry.size.x / 2.0f - 2,
+                        fry.position.y - fry.size.y / 2.0f - 2,
+                        fry.size.x + 4, fry.size.y + 4);
+        ofFill();
+    }
+    ofPopMatrix();
+}
+
+void ofApp::drawProfiler() {
+    string lines[2] = {
+        "update " + ofToString(updateMillis, 1) + " ms  draw " +
+            ofToString(drawMillis, 1) + " ms",
+        "input latency " + ofToString(inputLatencyMillis, 1) + " ms " +
+            (lateLatch ? "(late latch)" : "(event)")};
+    float width = std::max(lines[0].length(), lines[1].length()) * 8;
+    float x = 20;
+    float y = screenHeight - 34;
+
+    ofSetColor(0, 0, 0, 150);
+    ofDrawRectRounded(x - 8, y - 12, width + 16, 32, 3);
+    ofSetColor(160, 220, 160, 230);
+    ofDrawBitmapString(lines[0], x, y);
+    ofDrawBitmapString(lines[1], x, y + 14);
 }
 
 void ofApp::drawOil() {
@@ -184,17 +1199,19 @@ void ofApp::drawOil() {
                         deepColor.b * 0.55f, deepColor.a);
 
     int segments = 30;
+    int surfaceSegments = 160;
     float depth1 = oilTopY + (oilBottomY - oilTopY) * 0.25f;
     float depth2 = oilTopY + (oilBottomY - oilTopY) * 0.55f;
     float depth3 = oilTopY + (oilBottomY - oilTopY) * 0.8f;
 
-    // Layer 1: Surface to shallow
+    // Layer 1: Surface to shallow, following the simulated wave field over
+    // a slow convection swell
     ofMesh layer1;
     layer1.setMode(OF_PRIMITIVE_TRIANGLE_STRIP);
-    for (int i = 0; i <= segments; i++) {
-        float x = ofMap(i, 0, segments, oilLeft, oilRight);
-        float surfaceWave = ofNoise(x * 0.008f, elapsedTime * 0.4f) * 4;
-        surfaceWave += ofNoise(x * 0.02f, elapsedTime * 0.8f) * 2;
+    for (int i = 0; i <= surfaceSegments; i++) {
+        float x = ofMap(i, 0, surfaceSegments, oilLeft, oilRight);
+        float surfaceWave = ofNoise(x * 0.008f, elapsedTime * 0.4f) * 2;
+        surfaceWave -= surfaceWaves->getHeight(x);
 
         layer1.addVertex(ofVec3f(x, oilTopY + surfaceWave, 0));
         layer1.addColor(surfaceColor);
@@ -313,17 +1330,17 @@ void ofApp::drawOil() {
         ofFill();
     }
 
-    // Surface film
+    // Surface film, riding the same surface as the top oil layer
     ofSetColor(255, 245, 200, 15);
     ofBeginShape();
     for (float x = oilLeft; x <= oilRight; x += 6) {
-        float surfaceWave = ofNoise(x * 0.008f, elapsedTime * 0.4f) * 4;
-        surfaceWave += ofNoise(x * 0.02f, elapsedTime * 0.8f) * 2;
+        float surfaceWave = ofNoise(x * 0.008f, elapsedTime * 0.4f) * 2;
+        surfaceWave -= surfaceWaves->getHeight(x);
         ofVertex(x, oilTopY + surfaceWave);
     }
     for (float x = oilRight; x >= oilLeft; x -= 6) {
-        float surfaceWave = ofNoise(x * 0.008f, elapsedTime * 0.4f) * 4;
-        surfaceWave += ofNoise(x * 0.02f, elapsedTime * 0.8f) * 2;
+        float surfaceWave = ofNoise(x * 0.008f, elapsedTime * 0.4f) * 2;
+        surfaceWave -= surfaceWaves->getHeight(x);
         ofVertex(x, oilTopY + surfaceWave + 8);
     }
     ofEndShape(true);
@@ -332,7 +1349,7 @@ void ofApp::drawOil() {
 void ofApp::drawUI() {
     float lineHeight = 14;
     float panelY = 10;
-    float panelHeight = 125;
+    float panelHeight = 155;
     float colWidth = (screenWidth - 40) / 3;
 
     // Panel
@@ -349,6 +1366,16 @@ void ofApp::drawUI() {
     // Title
     ofSetColor(255, 200, 100, 255);
     string title = "DEEP-FRYING SIMULATION";
+    if (runMode == RUN_VIEW) {
+        title += viewSequence != 0
+                     ? " - FRYER " + ofToString(fryerIndex + 1)
+                     : " - WAITING FOR FRYER " + ofToString(fryerIndex + 1);
+    }
+    if (oilLog != nullptr) {
+        title += oilLogCursor->isAtEnd()
+                     ? " - OIL LOG ENDED"
+                     : " - OIL LOG " + ofToString(oilLogTime, 0) + " s";
+    }
     float titleX = (screenWidth - title.length() * 8) / 2;
     ofDrawBitmapString(title, titleX, panelY + 16);
 
@@ -366,11 +1393,17 @@ void ofApp::drawUI() {
     currentY += lineHeight;
     ofDrawBitmapString("[SPACE]   Drop/Remove", col1X, currentY);
     currentY += lineHeight;
+    ofDrawBitmapString("[B]       Basket", col1X, currentY);
+    currentY += lineHeight;
     ofDrawBitmapString("[P]       Pause", col1X, currentY);
     currentY += lineHeight;
     ofDrawBitmapString("[R]       Reset", col1X, currentY);
     currentY += lineHeight;
     ofDrawBitmapString("[MOUSE]   Drag", col1X, currentY);
+    currentY += lineHeight;
+    ofDrawBitmapString("[M]       MPC Temp", col1X, currentY);
+    currentY += lineHeight;
+    ofDrawBitmapString("[S]       Sound", col1X, currentY);
 
     // Column 2: Oil Properties
     float col2X = col1X + colWidth + 10;
@@ -399,10 +1432,40 @@ void ofApp::drawUI() {
                        col2X, currentY);
     currentY += lineHeight;
 
+    // Oil degradation
+    ofSetColor(200, 170, 110, 220);
+    ofDrawBitmapString(
+        "TPC: " + ofToString(oilSurface->polarCompounds, 3) + "%", col2X,
+        currentY);
+    currentY += lineHeight;
+
+    // Bubble load: discrete particles + void-fraction field
+    ofSetColor(200, 205, 210, 200);
+    ofDrawBitmapString("Bubbles: " + ofToString(particles.size()) + " + " +
+                           ofToString((int)bubbleField->getTotal()) +
+                           " field",
+                       col2X, currentY);
+    currentY += lineHeight;
+
     // Formulas
     currentY += 4;
     ofSetColor(100, 105, 110, 180);
     ofDrawBitmapString("p = 0.915 - 0.00064(T-20)", col2X, currentY);
+    currentY += lineHeight;
+
+    // Controller status
+    if (mpcEnabled) {
+        string mpcStr = "MPC: ";
+        if (oilController->predictedDoneTime >= 0) {
+            mpcStr += "done in " +
+                      ofToString(oilController->predictedDoneTime, 1) + "s";
+        } else {
+            mpcStr += "no plan";
+        }
+        mpcStr += " (" + ofToString(oilController->lastSolveMillis, 1) + "ms)";
+        ofSetColor(255, 200, 100, 220);
+        ofDrawBitmapString(mpcStr, col2X, currentY);
+    }
 
     // Column 3: Fry Status
     float col3X = col2X + colWidth;
@@ -412,20 +1475,24 @@ void ofApp::drawUI() {
     ofDrawBitmapString("FRY", col3X, currentY);
     currentY += lineHeight + 3;
 
-    if (potatoFry != nullptr) {
+    // Hovered or dragged fry if any, otherwise the single fry
+    Potato* fry = inspectedFry != nullptr ? inspectedFry : potatoFry;
+    bool showEventTimes = fry == potatoFry;
+
+    if (fry != nullptr) {
         float oilDens = getOilDensity();
-        float fryDens = potatoFry->density;
+        float fryDens = fry->density;
         bool isFloating = fryDens < oilDens;
 
         // Fry temperature
-        float heatTransfer = oilTemperature - potatoFry->temperature;
-        float fryTempNorm = ofMap(potatoFry->temperature, 20, 170, 0, 1, true);
+        float heatTransfer = oilTemperature - fry->temperature;
+        float fryTempNorm = ofMap(fry->temperature, 20, 170, 0, 1, true);
         ofColor fryTempColor =
             ofColor(100, 180, 255)
                 .getLerped(ofColor(255, 180, 80), fryTempNorm);
         ofSetColor(fryTempColor);
         string fryTempStr =
-            "Temp: " + ofToString(potatoFry->temperature, 1) + " C";
+            "Temp: " + ofToString(fry->temperature, 1) + " C";
         if (heatTransfer > 5) fryTempStr += " ^";
         ofDrawBitmapString(fryTempStr, col3X, currentY);
         currentY += lineHeight;
@@ -441,6 +1508,12 @@ void ofApp::drawUI() {
             buoyancyStr = " [SINK]";
         }
         ofSetColor(densColor);
+        if (isFloating && showEventTimes &&
+            fryEventTimes[FryEvent::FLOAT] >= 0) {
+            buoyancyStr = " [FLOAT " +
+                          ofToString(fryEventTimes[FryEvent::FLOAT], 1) +
+                          "s]";
+        }
         ofDrawBitmapString("Density: " + ofToString(fryDens, 3) + buoyancyStr,
                            col3X, currentY);
         currentY += lineHeight;
@@ -448,32 +1521,47 @@ void ofApp::drawUI() {
         // Moisture with evaporation indicator
         ofSetColor(100, 180, 220, 240);
         string moistureStr =
-            "H2O: " + ofToString(potatoFry->moistureContent * 100, 0) + "%";
-        if (potatoFry->temperature > 100 &&
-            potatoFry->moistureContent > 0.05f) {
+            "H2O: " + ofToString(fry->moistureContent * 100, 0) + "%";
+        if (fry->temperature > 100 && fry->moistureContent > 0.05f) {
             moistureStr += " [EVAP]";
         }
         ofDrawBitmapString(moistureStr, col3X, currentY);
         currentY += lineHeight;
 
         // Cookedness with progress indicator
-        float cookedPct = potatoFry->cookedness * 100;
-        float cookedNorm = potatoFry->cookedness;
+        float cookedPct = fry->cookedness * 100;
+        float cookedNorm = fry->cookedness;
         ofColor cookedColor =
             ofColor(180, 180, 180)
                 .getLerped(ofColor(220, 180, 100), cookedNorm);
         ofSetColor(cookedColor);
         string cookedStr = "Cooked: " + ofToString(cookedPct, 0) + "%";
-        if (cookedPct >= 70) cookedStr += " [DONE]";
+        if (showEventTimes && fryEventTimes[FryEvent::DONE] >= 0) {
+            cookedStr += " [DONE " +
+                         ofToString(fryEventTimes[FryEvent::DONE], 1) + "s]";
+        } else if (fry->cookedness >= Potato::DONE_COOKEDNESS) {
+            cookedStr += " [DONE]";
+        }
         ofDrawBitmapString(cookedStr, col3X, currentY);
         currentY += lineHeight;
 
         // Crust and time
         ofSetColor(220, 180, 120, 220);
         ofDrawBitmapString(
-            "Crust: " + ofToString(potatoFry->crustThickness * 100, 0) +
-                "%  t=" + ofToString(potatoFry->timeInOil, 1) + "s",
+            "Crust: " + ofToString(fry->crustThickness * 100, 0) +
+                "%  t=" + ofToString(fry->timeInOil, 1) + "s",
             col3X, currentY);
+
+        // Resolved conduction profile
+        if (fry->resolved) {
+            currentY += lineHeight;
+            ofSetColor(255, 180, 80, 220);
+            ofDrawBitmapString(
+                "Surface: " + ofToString(fry->getSurfaceTemperature(), 1) +
+                    " C  Core: " + ofToString(fry->getCoreTemperature(), 1) +
+                    " C",
+                col3X, currentY);
+        }
     } else {
         ofSetColor(120, 125, 130, 200);
         ofDrawBitmapString("No fry in oil", col3X, currentY);
@@ -498,15 +1586,157 @@ void ofApp::drawUI() {
 }
 
 void ofApp::keyPressed(int key) {
+    postInput(InputEvent::KEY_PRESS, key, 0, 0);
+}
+
+void ofApp::mouseMoved(int x, int y) {
+    latestPointer = ofVec2f(x, y);
+    latestPointerTime = ofGetElapsedTimef();
+    postInput(InputEvent::MOUSE_MOVE, 0, x, y);
+}
+
+void ofApp::mousePressed(int x, int y, int button) {
+    postInput(InputEvent::MOUSE_PRESS, 0, x, y);
+}
+
+void ofApp::mouseDragged(int x, int y, int button) {
+    latestPointer = ofVec2f(x, y);
+    latestPointerTime = ofGetElapsedTimef();
+    postInput(InputEvent::MOUSE_DRAG, 0, x, y);
+}
+
+void ofApp::mouseReleased(int x, int y, int button) {
+    postInput(InputEvent::MOUSE_RELEASE, 0, x, y);
+}
+
+void ofApp::postInput(InputEvent::Type type, int key, float x, float y) {
+    InputEvent event;
+    event.type = type;
+    event.key = key;
+    event.x = x;
+    event.y = y;
+    event.captureTime = ofGetElapsedTimef();
+    event.step = -1;
+    if (!inputQueue.push(event)) {
+        droppedInputs++;
+        ofLogWarning("ofApp") << "input queue full, dropped event";
+    }
+}
+
+void ofApp::processInput() {
+    InputEvent event;
+    while (inputQueue.pop(event)) {
+        // A replay stands in for live input
+        if (inputReplay != nullptr) continue;
+
+        event.step = fryStepCount;
+        applyInput(event);
+        recordInput(event);
+
+        // Without a late latch, the newest drag event is what gets drawn
+        if (event.type == InputEvent::MOUSE_DRAG &&
+            currentDraggedFry != nullptr &&
+            event.captureTime > shownPointerTime) {
+            shownPointerTime = event.captureTime;
+            newPointerSample = true;
+        }
+    }
+    if (inputReplay != nullptr) replayInput();
+
+    // Input may have dropped or removed fries
+    updateFryGrid();
+}
+
+void ofApp::recordInput(const InputEvent& event) {
+    if (inputRecord == nullptr) return;
+    *inputRecord << event.step << ' ' << (int)event.type << ' ' << event.key
+                 << ' ' << event.x << ' ' << event.y << '\n';
+}
+
+void ofApp::replayInput() {
+    // Applies every recorded event due before the next fry step; reading one
+    // line ahead keeps only that event in memory
+    while (true) {
+        if (!hasNextReplayed) {
+            int type;
+            InputEvent& event = nextReplayed;
+            if (!(*inputReplay >> event.step >> type >> event.key >>
+                  event.x >> event.y)) {
+                ofLogNotice("ofApp") << "input replay finished";
+                delete inputReplay;
+                inputReplay = nullptr;
+                return;
+            }
+            event.type = (InputEvent::Type)type;
+            event.captureTime = ofGetElapsedTimef();
+            hasNextReplayed = true;
+        }
+        if (nextReplayed.step > fryStepCount) return;
+        applyInput(nextReplayed);
+        hasNextReplayed = false;
+    }
+}
+
+void ofApp::applyInput(const InputEvent& event) {
+    // Viewers are read-only: hover inspects, digit keys pick the fryer
+    if (runMode == RUN_VIEW) {
+        if (event.type == InputEvent::MOUSE_MOVE) {
+            mousePosition = ofVec2f(event.x, event.y);
+        } else if (event.type == InputEvent::KEY_PRESS && event.key >= '1' &&
+                   event.key <= '9') {
+            attachViewer(event.key - '1');
+        }
+        return;
+    }
+
+    switch (event.type) {
+        case InputEvent::KEY_PRESS:
+            applyKey(event.key);
+            break;
+        case InputEvent::MOUSE_MOVE:
+            mousePosition = ofVec2f(event.x, event.y);
+            break;
+        case InputEvent::MOUSE_PRESS:
+            applyMousePress(event.x, event.y);
+            break;
+        case InputEvent::MOUSE_DRAG:
+            applyMouseDrag(event.x, event.y);
+            break;
+        case InputEvent::MOUSE_RELEASE:
+            applyMouseRelease();
+            break;
+        case InputEvent::SET_POINT:
+            targetTemperature = event.x;
+            break;
+    }
+}
+
+void ofApp::applyKey(int key) {
     if (key == 'p' || key == 'P') {
         isPaused = !isPaused;
     } else if (key == OF_KEY_UP) {
+        // Manual set point overrides the controller
+        mpcEnabled = false;
         targetTemperature = ofClamp(targetTemperature + 5, 160, 190);
     } else if (key == OF_KEY_DOWN) {
+        mpcEnabled = false;
         targetTemperature = ofClamp(targetTemperature - 5, 160, 190);
+    } else if (key == 'm' || key == 'M') {
+        mpcEnabled = !mpcEnabled;
+        controlTimer = 0;
+        oilController->cancel();
+    } else if (key == 'l' || key == 'L') {
+        lateLatch = !lateLatch;
+    } else if (key == 'o' || key == 'O') {
+        showProfiler = !showProfiler;
+    } else if (key == 's' || key == 'S') {
+        soundEnabled = !soundEnabled;
+        fryingSound->masterGain = soundEnabled ? 0.5f : 0.0f;
     } else if (key == ' ') {
         if (fryInOil) {
             if (potatoFry != nullptr) {
+                if (currentDraggedFry == potatoFry) currentDraggedFry = nullptr;
+                if (inspectedFry == potatoFry) inspectedFry = nullptr;
                 delete potatoFry;
                 potatoFry = nullptr;
             }
@@ -515,40 +1745,109 @@ void ofApp::keyPressed(int key) {
             // Spawn fry above oil surface
             // Raw potato (1.08 g/cm³) sinks in oil (~0.82 g/cm³)
             ofVec2f fryPos(screenWidth / 2, oilTopY - 80);
-            potatoFry = new Potato(fryPos, ofVec2f(120, 20));
+            potatoFry = new Potato(fryPos, ofVec2f(120, 20), simRng());
             potatoFry->velocity = ofVec2f(0, 100.0f);
+            potatoFry->onEvent = [this](const FryEvent& event) {
+                onFryEvent(event);
+            };
+            std::fill(fryEventTimes, fryEventTimes + 3, -1.0f);
+            oilController->reset();
             fryInOil = true;
         }
+    } else if (key == 'b' || key == 'B') {
+        if (basketFries.empty()) {
+            // Assorted hand cuts
+            BasketContents contents;
+            contents.numFries = 120;
+            contents.minLength = 70;
+            contents.maxLength = 100;
+            contents.minWidth = 12;
+            contents.maxWidth = 16;
+            dropBasket(contents);
+        } else {
+            removeBasket();
+        }
     } else if (key == 'r' || key == 'R') {
+        removeBasket();
         if (potatoFry != nullptr) {
             delete potatoFry;
             potatoFry = nullptr;
         }
+        currentDraggedFry = nullptr;
+        inspectedFry = nullptr;
         fryInOil = false;
         elapsedTime = 0;
+        std::fill(fryEventTimes, fryEventTimes + 3, -1.0f);
         particles.clear();
+        bubbleField->clear();
+        surfaceWaves->clear();
+        steam->count = 0;
+        splatter->count = 0;
+        if (scenario != nullptr) startScenario();
+        if (oilLog != nullptr) startOilLog();
     }
 }
 
-void ofApp::mousePressed(int x, int y, int button) {
-    if (potatoFry != nullptr) {
-        float dx = x - potatoFry->position.x;
-        float dy = y - potatoFry->position.y;
-        if (sqrt(dx * dx + dy * dy) < 60) {
-            currentDraggedFry = potatoFry;
-            dragPosition = ofVec2f(x, y);
-        }
+void ofApp::applyMousePress(float x, float y) {
+    mousePosition = ofVec2f(x, y);
+    Potato* fry = findFryAt(mousePosition);
+    if (fry == nullptr) {
+        clearSelection();
+        selecting = true;
+        selectionStart = mousePosition;
+        return;
     }
+
+    // A fry outside the selection is picked up on its own
+    if (!fry->selected) clearSelection();
+    currentDraggedFry = fry;
+    dragPosition = mousePosition;
 }
 
-void ofApp::mouseDragged(int x, int y, int button) {
+void ofApp::applyMouseDrag(float x, float y) {
+    mousePosition = ofVec2f(x, y);
     if (currentDraggedFry != nullptr) {
         dragPosition = ofVec2f(x, y);
     }
 }
 
-void ofApp::mouseReleased(int x, int y, int button) {
+void ofApp::applyMouseRelease() {
     currentDraggedFry = nullptr;
+    if (selecting) {
+        selecting = false;
+        selectFriesIn(getSelectionBand());
+    }
+}
+
+ofVec2f ofApp::sampleLatestPointer() {
+#ifdef HAS_GLFW_CURSOR
+    // Newer than the last callback, which only fires at the next event poll
+    auto window = dynamic_cast<ofAppGLFWWindow*>(ofGetWindowPtr());
+    if (window != nullptr) {
+        double x, y;
+        glfwGetCursorPos(window->getGLFWWindow(), &x, &y);
+        float scale = window->getPixelScreenCoordScale();
+        return ofVec2f(x * scale, y * scale);
+    }
+#endif
+    return latestPointer;
+}
+
+void ofApp::latchDrag() {
+    // The fry may lag its drag position until the next step, so the offset
+    // applies even when the pointer hasn't moved; only a new position needs
+    // posting
+    ofVec2f pointer = sampleLatestPointer();
+    latchOffset = pointer - currentDraggedFry->position;
+    if (pointer != dragPosition) {
+        postInput(InputEvent::MOUSE_DRAG, 0, pointer.x, pointer.y);
+    }
+
+    // Latency is measured from the newest callback, the last known input
+    if (latestPointerTime > shownPointerTime) {
+        shownPointerTime = latestPointerTime;
+        newPointerSample = true;
+    }
 }
 
 void ofApp::drawFryerContainer() {
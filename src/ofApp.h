@@ -1,8 +1,24 @@
 #pragma once
 
+#include <fstream>
+
 #include "Bubble.h"
+#include "FrameRing.h"
+#include "FryGrid.h"
+#include "FryerLog.h"
+#include "FryingSound.h"
+#include "InputEvent.h"
+#include "MultirateScheduler.h"
 #include "Oil.h"
+#include "OilController.h"
+#include "ParticlePool.h"
 #include "Potato.h"
+#include "ScenarioFile.h"
+#include "SpscQueue.h"
+#include "StateStream.h"
+#include "SurfaceWaves.h"
+#include "VoidFractionField.h"
+#include "WebSocketServer.h"
 #include "ofMain.h"
 
 /**
@@ -21,6 +37,20 @@
  */
 class ofApp : public ofBaseApp {
    public:
+    // LOCAL simulates and draws; PUBLISH simulates without drawing and
+    // publishes every frame to shared memory; VIEW draws a publisher's frames
+    enum RunMode { RUN_LOCAL, RUN_PUBLISH, RUN_VIEW };
+
+    // A scenario file, if given, plays its timeline on the local fryer; an
+    // oil log, if given, replaces the set point with logged oil
+    // temperatures. Applied input is recorded to inputRecordPath, or read
+    // back from inputReplayPath in place of live input.
+    explicit ofApp(RunMode mode = RUN_LOCAL, int fryer = 0,
+                   bool startWithBasket = false,
+                   const std::string& scenarioPath = "",
+                   const std::string& oilLogPath = "",
+                   const std::string& inputRecordPath = "",
+                   const std::string& inputReplayPath = "");
     void setup();
     ~ofApp();
     void update();
@@ -28,24 +58,76 @@ class ofApp : public ofBaseApp {
 
     void keyPressed(int key);
     void mousePressed(int x, int y, int button);
+    void mouseMoved(int x, int y);
     void mouseDragged(int x, int y, int button);
     void mouseReleased(int x, int y, int button);
 
+    void audioOut(ofSoundBuffer& buffer);
+
    private:
+    // Input callbacks only enqueue; state changes happen in apply*
+    void postInput(InputEvent::Type type, int key, float x, float y);
+    void processInput();
+    void applyInput(const InputEvent& event);
+    void recordInput(const InputEvent& event);
+    void replayInput();
+    void applyKey(int key);
+    void applyMousePress(float x, float y);
+    void applyMouseDrag(float x, float y);
+    void applyMouseRelease();
+    ofVec2f sampleLatestPointer();
+    void latchDrag();
+
+    void publishFrame();
+    void streamFrame(const FrameSnapshot& frame);
+    void attachViewer(int fryer);
+    void updateViewer();
+    void applyFrame(const FrameSnapshot& frame);
+
     void updateOilViscosity();
     float getOilDensity();
-    void updatePhysics(float dt);
+    void stepFries(float dt);
+    // Returns the heat (J) the fry drew from the oil, as mass kg of fries
+    float stepFry(Potato& fry, float dt, float oilDensity, float mass);
+    void updatePhysics(float dt, float viscosity);
     void spawnBubble(ofVec2f position, float temperature,
                      float depthBelowSurface);
+    void onFryEvent(const FryEvent& event);
+    void spawnBubblesForFry(Potato& fry, float dt);
+    float getDiscreteFraction(ofVec2f position, float depthBelowSurface);
+    void exchangeBubbles();
+    void updateBubbleField(float dt);
+    Potato* findFryAt(ofVec2f point);
+    Potato* getFry(int id);
+    void updateFryGrid();
+    void clearSelection();
+    void selectFriesIn(const ofRectangle& area);
+    ofRectangle getSelectionBand() const;
+    void updateFryLod();
+    void dropBasket(const BasketContents& contents);
+    void removeBasket();
+    void shakeBasket();
+    void startScenario();
+    void playScenario();
+    void applyScenarioAction(const ScenarioAction& action);
+    void startOilLog();
+    void stepOilLog(float dt);
+    float random(float low, float high);  // Uniform draw from simRng
+    void emitSteam(const Potato& fry, float expectedCount);
+    void emitSplatter(const Potato& fry);
 
     void drawBackground();
     void drawCountertop();
     void drawFryerHousing();
     void drawFryerContainer();
     void drawFryerBasket();
+    void drawFry(Potato& fry);
     void drawOil();
     void drawControlPanel();
     void drawUI();
+    void drawSteam();
+    void drawSplatter();
+    void drawProfiler();
 
     float screenWidth;
     float screenHeight;
@@ -67,13 +149,133 @@ class ofApp : public ofBaseApp {
     float oilViscosity;
 
     Oil* oilSurface;
+    SurfaceWaves* surfaceWaves;
+    OilController* oilController;
     Potato* potatoFry;
     Potato* currentDraggedFry;
+    Potato* inspectedFry;
+    std::vector<Potato> basketFries;
     std::vector<Bubble> particles;
 
+    // Small bubbles away from the cursor live in a void-fraction field;
+    // discrete particles are capped so a full basket stays bounded
+    VoidFractionField* bubbleField;
+    std::vector<float> fieldPopCarry;
+    static const int DISCRETE_BUBBLE_BUDGET = 1500;
+    static constexpr float LARGE_BUBBLE_SIZE = 8.0f;
+    static constexpr float FOCUS_RADIUS = 120.0f;
+    static constexpr float FIELD_RISE_SPEED = 140.0f;
+
+    // Above-surface effects, each capped at its own particle budget
+    ParticlePool* steam;
+    ParticlePool* splatter;
+    static const int STEAM_BUDGET = 800;
+    static const int SPLATTER_BUDGET = 400;
+    // ~100 steam particles/s from one fry evaporating at full rate
+    static constexpr float STEAM_PER_KG = 1.0e6f;
+    FryingSound* fryingSound;
+    ofSoundStream soundStream;
+    bool soundEnabled;
+
+    // Refined event times (s in oil), indexed by FryEvent::Type; -1 if unseen
+    float fryEventTimes[3];
+
     float elapsedTime;
     bool fryInOil;
     bool isPaused;
+    bool mpcEnabled;
+    float controlTimer;
+
+    MultirateScheduler scheduler;
+    int fryRate;
+    int chemistryRate;
+    static const int BUBBLE_SUBSTEPS = 4;
+    static const int MAX_RELEASES_PER_STEP = 64;
+
+    // Water (kg) evaporated from fries since the last chemistry step
+    float pendingWaterReleased;
+    static constexpr float FRY_MASS = 0.005f;
 
     ofVec2f dragPosition;
+    ofVec2f mousePosition;
+
+    // Picking grid of the fries, rebuilt after every step, input drain and
+    // viewer frame. Ids follow draw order: basket fries by index, then the
+    // single fry on top
+    FryGrid* fryGrid;
+    static const int SINGLE_FRY_ID = 1 << 30;
+    static constexpr float PICK_MARGIN = 4.0f;
+
+    // Dragging across empty oil selects the fries under the band; dragging
+    // any selected fry then moves the whole group
+    std::vector<int> selectedFries;  // Ids
+    bool selecting;
+    ofVec2f selectionStart;
+
+    // UI thread -> simulation
+    SpscQueue<InputEvent, 1024> inputQueue;
+    int droppedInputs;
+    int fryStepCount;  // Fixed fry steps taken; stamps applied input
+
+    // Opt-in input recording (LOCAL mode): applied events are streamed to
+    // a file, one line each, or replayed from one before the fry step they
+    // were recorded at, so memory use doesn't grow with session length
+    std::string inputRecordPath;
+    std::string inputReplayPath;
+    std::ofstream* inputRecord;
+    std::ifstream* inputReplay;
+    InputEvent nextReplayed;
+    bool hasNextReplayed;
+
+    // Every random draw that affects the simulation (fry placement, cut
+    // sizes and seeds, bubbles, steam, splatter) comes from simRng, seeded
+    // from simSeed, which recordings store and replays restore
+    unsigned int simSeed;
+    std::mt19937 simRng;
+
+    // Late-latched drag (L): draw re-reads the pointer just before drawing
+    // and offsets the dragged fry to it; the sample is also posted as a drag
+    // event, so physics follows at the next step and recordings capture it
+    bool lateLatch;
+    ofVec2f latestPointer;    // Newest position seen by a mouse callback
+    float latestPointerTime;  // Wall clock (s) of that callback
+    ofVec2f latchOffset;      // Dragged fry render offset for this frame
+    float shownPointerTime;   // Wall clock (s) of the pointer sample drawn
+    bool newPointerSample;    // A newer sample is drawn this frame
+
+    // Profiler overlay (O), smoothed over recent frames
+    bool showProfiler;
+    float frameStartTime;  // Wall clock (s) at the start of update
+    float updateMillis;
+    float drawMillis;
+    float inputLatencyMillis;  // Pointer sample to the end of draw
+
+    // Shared-memory frames: written in PUBLISH mode, read in VIEW mode
+    RunMode runMode;
+    int fryerIndex;
+    bool startWithBasket;
+    FrameRing* frameRing;
+    FrameSnapshot* viewFrame;
+    uint64_t viewSequence;
+    float viewStaleTime;  // s without a new frame
+    static constexpr float VIEW_STALE_TIMEOUT = 2.0f;
+
+    // Scripted timeline (LOCAL mode): next step and recorded CSV rows
+    std::string scenarioPath;
+    ScenarioFile* scenario;
+    size_t scenarioStep;
+    float scenarioStartTime;
+    std::string scenarioCsv;
+
+    // Recorded oil temperatures (LOCAL mode) driving the oil instead of the
+    // set point; baskets go in and out as the log's fry count says
+    std::string oilLogPath;
+    FryerLog* oilLog;
+    FryerLogCursor* oilLogCursor;
+    double oilLogTime;  // s, log timeline
+    bool oilLogBasketIn;
+
+    // Delta-coded dashboard stream (PUBLISH mode)
+    WebSocketServer* dashboardServer;
+    StateEncoder* stateEncoder;
 };